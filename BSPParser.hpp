@@ -27,7 +27,22 @@ namespace BspParser {
   namespace Zip {}
 }
 
+#include "./src/accessors/entity-accessors.hpp"
 #include "./src/accessors/face-accessors.hpp"
+#include "./src/accessors/leaf-accessors.hpp"
+#include "./src/accessors/lightmap-accessors.hpp"
 #include "./src/accessors/prop-accessors.hpp"
 #include "./src/accessors/texture-accessors.hpp"
 #include "./src/bsp.hpp"
+#include "./src/displacements/displacement-collision.hpp"
+#include "./src/displacements/displacement-links.hpp"
+#include "./src/lighting/ambient-lighting-table.hpp"
+#include "./src/lighting/colour-decoding.hpp"
+#include "./src/lighting/lightmap-atlas.hpp"
+#include "./src/lighting/world-light-index.hpp"
+#include "./src/occlusion/occlusion-buffer.hpp"
+#include "./src/overlays/overlay-meshes.hpp"
+#include "./src/static-props/static-prop-batches.hpp"
+#include "./src/static-props/static-prop-spatial-index.hpp"
+#include "./src/topology/area-graph.hpp"
+#include "./src/topology/face-adjacency.hpp"
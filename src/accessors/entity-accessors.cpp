@@ -0,0 +1,33 @@
+#include "entity-accessors.hpp"
+
+namespace BspParser::Accessors {
+  namespace {
+    void iterateIndexedEntities(
+      const Bsp& bsp,
+      const std::unordered_map<std::string_view, std::vector<size_t>>& index,
+      const std::string_view value,
+      const std::function<void(const Entity& entity)>& iteratee
+    ) {
+      const auto entry = index.find(value);
+      if (entry == index.end()) {
+        return;
+      }
+
+      for (const auto entityIndex : entry->second) {
+        iteratee(bsp.entities[entityIndex]);
+      }
+    }
+  }
+
+  void iterateEntitiesByClassName(
+    const Bsp& bsp, const std::string_view className, const std::function<void(const Entity& entity)>& iteratee
+  ) {
+    iterateIndexedEntities(bsp, bsp.entitiesByClassName, className, iteratee);
+  }
+
+  void iterateEntitiesByTargetName(
+    const Bsp& bsp, const std::string_view targetName, const std::function<void(const Entity& entity)>& iteratee
+  ) {
+    iterateIndexedEntities(bsp, bsp.entitiesByTargetName, targetName, iteratee);
+  }
+}
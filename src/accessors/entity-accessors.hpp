@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include <functional>
+
+namespace BspParser::Accessors {
+  /**
+   * Calls the given function for each entity with the given classname, in lump order.
+   * @param bsp BSP instance.
+   * @param className Classname to look up.
+   * @param iteratee Function to be called.
+   */
+  void iterateEntitiesByClassName(
+    const Bsp& bsp, std::string_view className, const std::function<void(const Entity& entity)>& iteratee
+  );
+
+  /**
+   * Calls the given function for each entity with the given targetname, in lump order.
+   * @param bsp BSP instance.
+   * @param targetName Targetname to look up.
+   * @param iteratee Function to be called.
+   */
+  void iterateEntitiesByTargetName(
+    const Bsp& bsp, std::string_view targetName, const std::function<void(const Entity& entity)>& iteratee
+  );
+}
@@ -15,20 +15,22 @@ namespace BspParser::Accessors {
 
   void iterateModels(
     const Bsp& bsp,
-    const std::function<void(const Structs::Model& model, const std::vector<PhysModel>& physicsModels)>& iteratee
+    const std::function<void(const Structs::Model& model, std::span<const PhysModel> physicsModels)>& iteratee
   ) {
-    std::vector<PhysModel> physicsModels;
-
-    for (int32_t modelIndex = 0; modelIndex < bsp.models.size(); modelIndex++) {
-      physicsModels.clear();
-      for (const auto& physModel : bsp.physicsModels) {
-        if (physModel.modelIndex == modelIndex) {
-          physicsModels.push_back(physModel);
-        }
-      }
+    for (size_t modelIndex = 0; modelIndex < bsp.models.size(); modelIndex++) {
+      iteratee(bsp.models[modelIndex], getPhysicsModels(bsp, modelIndex));
+    }
+  }
 
-      iteratee(bsp.models[modelIndex], physicsModels);
+  std::span<const PhysModel> getPhysicsModels(const Bsp& bsp, const size_t modelIndex) {
+    if (modelIndex >= bsp.models.size()) {
+      throw std::out_of_range(std::format("Model index '{}' is out of bounds of the models lump", modelIndex));
     }
+
+    const auto firstPhysicsModel = bsp.modelPhysicsModelOffsets[modelIndex];
+    const auto numPhysicsModels = bsp.modelPhysicsModelOffsets[modelIndex + 1] - firstPhysicsModel;
+
+    return std::span(bsp.physicsModels).subspan(firstPhysicsModel, numPhysicsModels);
   }
 
   void iterateFaces(
@@ -124,7 +126,7 @@ namespace BspParser::Accessors {
     assertFaceCanBeTriangulated(surfaceEdges);
 
     if (face.dispInfo < 0) {
-      return (surfaceEdges.size() - 2) * 3;
+      return getFaceTriangleListIndexCount(bsp, face, surfaceEdges);
     }
 
     return bsp.displacements[face.dispInfo].getTriangleListIndexCount();
@@ -152,7 +154,7 @@ namespace BspParser::Accessors {
     const auto& textureData = bsp.textureDatas[textureInfo.texData];
 
     if (face.dispInfo < 0) {
-      generateFaceVertices(bsp, plane, textureInfo, textureData, surfaceEdges, iteratee);
+      generateFaceVertices(bsp, face, plane, textureInfo, textureData, surfaceEdges, iteratee);
     } else {
       const auto& displacement = bsp.displacements[face.dispInfo];
 
@@ -162,6 +164,35 @@ namespace BspParser::Accessors {
     }
   }
 
+  void generateVertices(
+    const Bsp& bsp,
+    const Structs::Face& face,
+    const Structs::Plane& plane,
+    const Structs::TexInfo& textureInfo,
+    const std::span<const int32_t> surfaceEdges,
+    const LightmapAtlas& lightmapAtlas,
+    const std::function<void(const Vertex& vertex)>& iteratee
+  ) {
+    const auto faceIndex = findFaceIndex(bsp, face);
+    if (!faceIndex.has_value()) {
+      throw std::invalid_argument("Face must be an element of the BSP's faces to look up its lightmap atlas rectangle");
+    }
+
+    if (faceIndex.value() >= lightmapAtlas.faceRects.size()) {
+      throw std::invalid_argument("Lightmap atlas was not built from the same BSP as the face");
+    }
+
+    const auto& rect = lightmapAtlas.faceRects[faceIndex.value()];
+
+    generateVertices(bsp, face, plane, textureInfo, surfaceEdges, [&](const Vertex& vertex) {
+      auto remapped = vertex;
+      remapped.lightmapUv =
+        rect.has_value() ? lightmapAtlas.getPageUv(rect.value(), vertex.lightmapUv) : Structs::Vector2{};
+
+      iteratee(remapped);
+    });
+  }
+
   void generateTriangleListIndices(
     const Bsp& bsp,
     const Structs::Face& face,
@@ -171,7 +202,24 @@ namespace BspParser::Accessors {
     assertFaceCanBeTriangulated(surfaceEdges);
 
     if (face.dispInfo < 0) {
-      generateFaceTriangleListIndices(surfaceEdges, iteratee);
+      generateFaceTriangleListIndices(bsp, face, surfaceEdges, iteratee);
+    } else {
+      const auto& displacement = bsp.displacements[face.dispInfo];
+
+      displacement.generateTriangleListIndices(iteratee);
+    }
+  }
+
+  void generateMinimumWeightTriangleListIndices(
+    const Bsp& bsp,
+    const Structs::Face& face,
+    const std::span<const int32_t> surfaceEdges,
+    const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
+  ) {
+    assertFaceCanBeTriangulated(surfaceEdges);
+
+    if (face.dispInfo < 0) {
+      generateFaceMinimumWeightTriangleListIndices(bsp, face, surfaceEdges, iteratee);
     } else {
       const auto& displacement = bsp.displacements[face.dispInfo];
 
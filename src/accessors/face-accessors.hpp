@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../bsp.hpp"
+#include "../lighting/lightmap-atlas.hpp"
 #include "../structs/geometry.hpp"
 #include "../structs/models.hpp"
 #include "../vertex.hpp"
@@ -17,9 +18,18 @@ namespace BspParser::Accessors {
    */
   void iterateModels(
     const Bsp& bsp,
-    const std::function<void(const Structs::Model& model, const std::vector<PhysModel>& physicsModels)>& iteratee
+    const std::function<void(const Structs::Model& model, std::span<const PhysModel> physicsModels)>& iteratee
   );
 
+  /**
+   * Returns the physics models of a model without searching, using the index built when parsing.
+   * @param bsp BSP instance.
+   * @param modelIndex Index into the model lump.
+   * @return View into Bsp::physicsModels. Empty if the model has no physics models.
+   * @throws std::out_of_range The model doesn't exist.
+   */
+  std::span<const PhysModel> getPhysicsModels(const Bsp& bsp, size_t modelIndex);
+
   /**
    * Calls the provided function for each face in the BSP's model,
    * passing a reference to the Structs::Face along with its corresponding Structs::Plane, Structs::TexInfo and surface edge indices.
@@ -62,14 +72,39 @@ namespace BspParser::Accessors {
 
   /**
    * Calls iteratee once for each unique vertex in the face's edges or displacement.
-   * Generates normals, tangents and UVs.
+   * Generates normals (using the smoothed vertex normals compiled into the BSP where available), tangents and UVs.
+   * @param bsp BSP instance.
+   * @param face Face to generate vertices for. Must be an element of bsp.faces, as passed by iterateFaces, if the BSP
+   * has compiled vertex normals.
+   * @param plane Plane referenced by the face.
+   * @param textureInfo Texture info referenced by the face.
+   * @param surfaceEdges Surface edge indices of the face.
+   * @param iteratee Function to call with each generated vertex.
+   * @throws std::runtime_error Face cannot be triangulated (less than 3 edges).
+   * @throws std::invalid_argument The BSP has compiled vertex normals, and face is not a displacement and is not an
+   * element of bsp.faces.
+   */
+  void generateVertices(
+    const Bsp& bsp,
+    const Structs::Face& face,
+    const Structs::Plane& plane,
+    const Structs::TexInfo& textureInfo,
+    std::span<const int32_t> surfaceEdges,
+    const std::function<void(const Vertex& vertex)>& iteratee
+  );
+
+  /**
+   * Same as generateVertices, but with Vertex::lightmapUv remapped into the face's page of the lightmap atlas.
+   * Vertices of faces without a lightmap have a lightmap UV of zero.
    * @param bsp BSP instance.
-   * @param face Face to generate vertices for.
+   * @param face Face to generate vertices for. Must be an element of bsp.faces, as passed by iterateFaces.
    * @param plane Plane referenced by the face.
    * @param textureInfo Texture info referenced by the face.
    * @param surfaceEdges Surface edge indices of the face.
+   * @param lightmapAtlas Atlas built from the same BSP.
    * @param iteratee Function to call with each generated vertex.
    * @throws std::runtime_error Face cannot be triangulated (less than 3 edges).
+   * @throws std::invalid_argument Face is not an element of bsp.faces.
    */
   void generateVertices(
     const Bsp& bsp,
@@ -77,11 +112,13 @@ namespace BspParser::Accessors {
     const Structs::Plane& plane,
     const Structs::TexInfo& textureInfo,
     std::span<const int32_t> surfaceEdges,
+    const LightmapAtlas& lightmapAtlas,
     const std::function<void(const Vertex& vertex)>& iteratee
   );
 
   /**
    * Calls iteratee once for each triangle forming a mesh which triangulates the given face.
+   * Uses the face's precomputed primitives when present, which avoid the cracks a fan leaves at T-junctions.
    * Indices start from 0 and index into the vertices generated by generateFaceVertices.
    * @param bsp BSP instance.
    * @param face Face to generate a triangle list for.
@@ -95,4 +132,21 @@ namespace BspParser::Accessors {
     std::span<const int32_t> surfaceEdges,
     const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
   );
+
+  /**
+   * Same as generateTriangleListIndices, but triangulates plain faces without primitives by minimising
+   * the total edge length and avoiding slivers, which suits rasterisation and collision better than a fan.
+   * Emits the same number of indices as generateTriangleListIndices.
+   * @param bsp BSP instance.
+   * @param face Face to generate a triangle list for.
+   * @param surfaceEdges Surface edge indices of the face.
+   * @param iteratee Called with each triplet of indices defining a triangle with clockwise winding.
+   * @throws std::runtime_error Face cannot be triangulated (less than 3 edges).
+   */
+  void generateMinimumWeightTriangleListIndices(
+    const Bsp& bsp,
+    const Structs::Face& face,
+    std::span<const int32_t> surfaceEdges,
+    const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
+  );
 }
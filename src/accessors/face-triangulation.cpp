@@ -3,40 +3,309 @@
 #include "../helpers/calculate-uvs.hpp"
 #include "../helpers/get-vertex-position.hpp"
 #include "../helpers/vector-maths.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 namespace BspParser::Internal::Accessors {
+  namespace {
+    constexpr size_t VERTEX_CHUNK_SIZE = 64;
+
+    /**
+     * Faces with more vertices than this fall back to the default triangulation to bound the cubic cost.
+     */
+    constexpr size_t MAX_MINIMUM_WEIGHT_VERTICES = 128;
+
+    /**
+     * Returns the face's primitives if they can be used to triangulate its own vertices, otherwise an empty span.
+     */
+    std::span<const Structs::Primitive> getFacePrimitives(const Bsp& bsp, const Structs::Face& face) {
+      const auto numPrimitives = static_cast<size_t>(face.numPrimitives & Structs::PRIMITIVE_COUNT_MASK);
+      if (numPrimitives == 0) {
+        return {};
+      }
+
+      if (face.firstPrimitiveId + numPrimitives > bsp.primitives.size()) {
+        throw Errors::OutOfBoundsAccess(
+          Enums::Lump::Faces,
+          std::format(
+            "Face's firstPrimitiveId + numPrimitives ({} + {}) is greater than the size of the primitives lump",
+            face.firstPrimitiveId,
+            numPrimitives
+          )
+        );
+      }
+
+      const auto primitives = bsp.primitives.subspan(face.firstPrimitiveId, numPrimitives);
+
+      // Primitives with their own vertices replace the face's geometry rather than triangulating it
+      for (const auto& primitive : primitives) {
+        if (primitive.vertexCount != 0) {
+          return {};
+        }
+      }
+
+      return primitives;
+    }
+
+    template <typename Callback>
+    void forEachPrimitiveTriangle(
+      const Bsp& bsp,
+      const std::span<const Structs::Primitive> primitives,
+      const size_t numVertices,
+      const Callback& callback
+    ) {
+      for (const auto& primitive : primitives) {
+        if (primitive.firstIndex + primitive.indexCount > bsp.primitiveIndices.size()) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::Primitives,
+            std::format(
+              "Primitive's firstIndex + indexCount ({} + {}) is greater than the size of the primitive indices lump",
+              primitive.firstIndex,
+              primitive.indexCount
+            )
+          );
+        }
+
+        const auto indices = bsp.primitiveIndices.subspan(primitive.firstIndex, primitive.indexCount);
+        for (const auto index : indices) {
+          if (index >= numVertices) {
+            throw Errors::OutOfBoundsAccess(
+              Enums::Lump::PrimitiveIndices,
+              std::format("Primitive index '{}' is out of bounds of the face's {} vertices", index, numVertices)
+            );
+          }
+        }
+
+        switch (primitive.type) {
+          case Enums::PrimitiveType::TriangleList:
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+              callback(indices[i], indices[i + 1], indices[i + 2]);
+            }
+            break;
+          case Enums::PrimitiveType::TriangleStrip:
+            for (size_t i = 0; i + 2 < indices.size(); i++) {
+              // Every other triangle in a strip is wound the opposite way
+              const uint32_t i0 = indices[i % 2 == 0 ? i : i + 1];
+              const uint32_t i1 = indices[i % 2 == 0 ? i + 1 : i];
+              const uint32_t i2 = indices[i + 2];
+
+              // Strips are stitched together with degenerate triangles
+              if (i0 != i1 && i1 != i2 && i0 != i2) {
+                callback(i0, i1, i2);
+              }
+            }
+            break;
+          default:
+            throw Errors::InvalidBody(
+              Enums::Lump::Primitives,
+              std::format("Unknown primitive type '{}'", static_cast<uint32_t>(primitive.type))
+            );
+        }
+      }
+    }
+
+    /**
+     * Returns the face's compiled vertex normal indices, or an empty span if the BSP has none for it.
+     * @throws std::invalid_argument The BSP has compiled normals and face is not an element of bsp.faces.
+     */
+    std::span<const uint16_t> getVertexNormalIndices(
+      const Bsp& bsp, const Structs::Face& face, const size_t numVertices
+    ) {
+      // Any face can fall back to its plane normal when there are no compiled normals to look up
+      if (bsp.vertexNormals.empty() || bsp.vertexNormalIndices.empty()) {
+        return {};
+      }
+
+      const auto faceIndex = findFaceIndex(bsp, face);
+      if (!faceIndex.has_value()) {
+        throw std::invalid_argument(
+          "Face must be an element of the BSP's faces to look up its compiled vertex normals"
+        );
+      }
+
+      if (faceIndex.value() >= bsp.faceFirstVertexNormals.size()) {
+        return {};
+      }
+
+      const auto firstVertexNormal = bsp.faceFirstVertexNormals[faceIndex.value()];
+      if (firstVertexNormal + numVertices > bsp.vertexNormalIndices.size()) {
+        return {};
+      }
+
+      return bsp.vertexNormalIndices.subspan(firstVertexNormal, numVertices);
+    }
+  }
+
+  std::optional<size_t> findFaceIndex(const Bsp& bsp, const Structs::Face& face) {
+    const auto* const facePointer = &face;
+    const auto isInFaces = std::greater_equal()(facePointer, bsp.faces.data()) &&
+      std::less()(facePointer, bsp.faces.data() + bsp.faces.size());
+
+    if (!isInFaces) {
+      return std::nullopt;
+    }
+
+    return static_cast<size_t>(facePointer - bsp.faces.data());
+  }
+
   void generateFaceVertices(
     const Bsp& bsp,
+    const Structs::Face& face,
     const Structs::Plane& plane,
     const Structs::TexInfo& textureInfo,
     const Structs::TexData& textureData,
     const std::span<const int32_t> surfaceEdges,
     const std::function<void(const Vertex& vertex)>& iteratee
   ) {
+    // Prefer the smoothed normals compiled by VRAD, falling back to the flat plane normal
     // Dev wiki says face.side is non-zero when the plane faces into the face, but inverting the normal based on that produces incorrect results
-    const auto normal = plane.normal;
+    const auto normalIndices = getVertexNormalIndices(bsp, face, surfaceEdges.size());
 
-    for (const auto& surfEdge : surfaceEdges) {
-      const auto& position = getVertexPosition(bsp.edges, bsp.vertices, surfEdge);
+    std::array<Structs::Vector, VERTEX_CHUNK_SIZE> normals;
+    std::array<Structs::Vector4, VERTEX_CHUNK_SIZE> tangents;
 
-      iteratee(
-        Vertex{
-          .position = position,
-          .normal = normal,
-          .tangent = calculateTangent(normal, textureInfo),
-          .uv = calculateUvs(position, textureInfo, textureData),
-        }
-      );
+    for (size_t chunkStart = 0; chunkStart < surfaceEdges.size(); chunkStart += VERTEX_CHUNK_SIZE) {
+      const auto chunkSize = std::min(VERTEX_CHUNK_SIZE, surfaceEdges.size() - chunkStart);
+
+      for (size_t i = 0; i < chunkSize; i++) {
+        const auto normalIndex = normalIndices.empty() ? bsp.vertexNormals.size() : normalIndices[chunkStart + i];
+        normals[i] = normalIndex < bsp.vertexNormals.size() ? bsp.vertexNormals[normalIndex] : plane.normal;
+      }
+
+      calculateTangents(std::span(normals).first(chunkSize), textureInfo, std::span(tangents).first(chunkSize));
+
+      for (size_t i = 0; i < chunkSize; i++) {
+        const auto& position = getVertexPosition(bsp.edges, bsp.vertices, surfaceEdges[chunkStart + i]);
+
+        iteratee(
+          Vertex{
+            .position = position,
+            .normal = normals[i],
+            .tangent = tangents[i],
+            .uv = calculateUvs(position, textureInfo, textureData),
+            .lightmapUv = calculateLightmapUvs(position, textureInfo, face),
+          }
+        );
+      }
     }
   }
 
+  size_t getFaceTriangleListIndexCount(
+    const Bsp& bsp, const Structs::Face& face, const std::span<const int32_t> surfaceEdges
+  ) {
+    const auto primitives = getFacePrimitives(bsp, face);
+    if (primitives.empty()) {
+      return (surfaceEdges.size() - 2) * 3;
+    }
+
+    size_t numIndices = 0;
+    forEachPrimitiveTriangle(bsp, primitives, surfaceEdges.size(), [&numIndices](uint32_t, uint32_t, uint32_t) {
+      numIndices += 3;
+    });
+
+    return numIndices;
+  }
+
   void generateFaceTriangleListIndices(
+    const Bsp& bsp,
+    const Structs::Face& face,
     const std::span<const int32_t> surfaceEdges,
     const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
   ) {
+    const auto primitives = getFacePrimitives(bsp, face);
+    if (!primitives.empty()) {
+      forEachPrimitiveTriangle(bsp, primitives, surfaceEdges.size(), iteratee);
+      return;
+    }
+
     // First and last edge are ignored as they would create duplicate/degenerate/overlapping triangles
     for (uint32_t edgeIndex = 1; edgeIndex < surfaceEdges.size() - 1; edgeIndex++) {
       iteratee(0, edgeIndex, edgeIndex + 1);
     }
   }
+
+  void generateFaceMinimumWeightTriangleListIndices(
+    const Bsp& bsp,
+    const Structs::Face& face,
+    const std::span<const int32_t> surfaceEdges,
+    const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
+  ) {
+    const auto numVertices = surfaceEdges.size();
+    if (!getFacePrimitives(bsp, face).empty() || numVertices <= 3 || numVertices > MAX_MINIMUM_WEIGHT_VERTICES) {
+      generateFaceTriangleListIndices(bsp, face, surfaceEdges, iteratee);
+      return;
+    }
+
+    std::vector<Structs::Vector> positions;
+    positions.reserve(numVertices);
+    for (const auto surfaceEdge : surfaceEdges) {
+      positions.push_back(getVertexPosition(bsp.edges, bsp.vertices, surfaceEdge));
+    }
+
+    const auto getDistance = [&positions](const size_t a, const size_t b) {
+      return length(sub(positions[b], positions[a]));
+    };
+
+    // Area below which a triangle is treated as a sliver, relative to the square of its longest edge
+    constexpr auto minRelativeArea = 1e-4f;
+    constexpr auto infinity = std::numeric_limits<float>::infinity();
+
+    // Classic O(n^3) dynamic programme over convex sub-polygons i..j, weighting each triangle by its perimeter
+    std::vector<float> costs(numVertices * numVertices, 0.f);
+    std::vector<uint16_t> splits(numVertices * numVertices, 0);
+
+    for (size_t span = 2; span < numVertices; span++) {
+      for (size_t i = 0; i + span < numVertices; i++) {
+        const auto j = i + span;
+        auto bestCost = infinity;
+        size_t bestSplit = i + 1;
+
+        for (auto k = i + 1; k < j; k++) {
+          const auto edgeIk = getDistance(i, k);
+          const auto edgeKj = getDistance(k, j);
+          const auto edgeIj = getDistance(i, j);
+          const auto longestEdge = std::max({edgeIk, edgeKj, edgeIj});
+          const auto doubleArea = length(cross(sub(positions[k], positions[i]), sub(positions[j], positions[i])));
+
+          if (doubleArea <= minRelativeArea * longestEdge * longestEdge) {
+            continue;
+          }
+
+          const auto cost = costs[i * numVertices + k] + costs[k * numVertices + j] + edgeIk + edgeKj + edgeIj;
+          if (cost < bestCost) {
+            bestCost = cost;
+            bestSplit = k;
+          }
+        }
+
+        costs[i * numVertices + j] = bestCost;
+        splits[i * numVertices + j] = static_cast<uint16_t>(bestSplit);
+      }
+    }
+
+    if (std::isinf(costs[numVertices - 1])) {
+      // Every triangulation contains a sliver (e.g. many collinear vertices), so none is better than the fan
+      generateFaceTriangleListIndices(bsp, face, surfaceEdges, iteratee);
+      return;
+    }
+
+    std::vector<std::pair<size_t, size_t>> stack{{0, numVertices - 1}};
+    while (!stack.empty()) {
+      const auto [i, j] = stack.back();
+      stack.pop_back();
+
+      if (j - i < 2) {
+        continue;
+      }
+
+      const auto k = splits[i * numVertices + j];
+      iteratee(static_cast<uint32_t>(i), static_cast<uint32_t>(k), static_cast<uint32_t>(j));
+
+      stack.emplace_back(i, k);
+      stack.emplace_back(k, j);
+    }
+  }
 }
@@ -3,10 +3,17 @@
 #include "../bsp.hpp"
 #include "../vertex.hpp"
 #include <functional>
+#include <optional>
 
 namespace BspParser::Internal::Accessors {
+  /**
+   * Returns the index of a face which is an element of bsp.faces, or nullopt if it is not (e.g. a copy).
+   */
+  std::optional<size_t> findFaceIndex(const Bsp& bsp, const Structs::Face& face);
+
   void generateFaceVertices(
     const Bsp& bsp,
+    const Structs::Face& face,
     const Structs::Plane& plane,
     const Structs::TexInfo& textureInfo,
     const Structs::TexData& textureData,
@@ -14,7 +21,21 @@ namespace BspParser::Internal::Accessors {
     const std::function<void(const Vertex& vertex)>& iteratee
   );
 
+  size_t getFaceTriangleListIndexCount(
+    const Bsp& bsp, const Structs::Face& face, std::span<const int32_t> surfaceEdges
+  );
+
   void generateFaceTriangleListIndices(
-    std::span<const int32_t> surfaceEdges, const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
+    const Bsp& bsp,
+    const Structs::Face& face,
+    std::span<const int32_t> surfaceEdges,
+    const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
+  );
+
+  void generateFaceMinimumWeightTriangleListIndices(
+    const Bsp& bsp,
+    const Structs::Face& face,
+    std::span<const int32_t> surfaceEdges,
+    const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
   );
 }
@@ -0,0 +1,133 @@
+#include "leaf-accessors.hpp"
+#include "../helpers/vector-maths.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace BspParser::Accessors {
+  using namespace Internal;
+
+  namespace {
+    template <class Leaf>
+    const Structs::LeafWaterData* getWaterData(const Bsp& bsp, const Leaf& leaf) {
+      if (leaf.leafWaterDataId < 0) {
+        return nullptr;
+      }
+
+      if (leaf.leafWaterDataId >= bsp.leafWaterData.size()) {
+        throw Errors::OutOfBoundsAccess(
+          Enums::Lump::Leaves,
+          std::format("Leaf water data index '{}' is out of bounds of the leaf water data lump", leaf.leafWaterDataId)
+        );
+      }
+
+      return &bsp.leafWaterData[leaf.leafWaterDataId];
+    }
+
+    template <class Leaf>
+    WaterSample sampleLeafWater(const Bsp& bsp, const std::span<const Leaf> leaves, const Structs::Vector& point) {
+      const auto waterContents = static_cast<int32_t>(Enums::Contents::Water | Enums::Contents::Slime);
+
+      const auto leafIndex = findLeaf(bsp, point);
+      const auto& leaf = leaves[leafIndex];
+      const auto* waterData = getWaterData(bsp, leaf);
+
+      return WaterSample{
+        .leafIndex = static_cast<uint32_t>(leafIndex),
+        .isUnderwater = (leaf.contents & waterContents) != 0,
+        .surfaceZ = waterData != nullptr ? waterData->surfaceZ : std::numeric_limits<float>::quiet_NaN(),
+        .minDistanceToWater = leafIndex < bsp.leafMinDistancesToWater.size()
+          ? static_cast<float>(bsp.leafMinDistancesToWater[leafIndex])
+          : std::numeric_limits<float>::infinity(),
+      };
+    }
+
+    void assertLeafValid(const Bsp& bsp, const size_t leafIndex) {
+      if (leafIndex >= getLeafCount(bsp)) {
+        throw std::out_of_range(std::format("Leaf index '{}' is out of bounds of the leaves lump", leafIndex));
+      }
+    }
+  }
+
+  size_t getLeafCount(const Bsp& bsp) {
+    return std::visit([](const auto& leaves) { return leaves.size(); }, bsp.leaves);
+  }
+
+  size_t findLeaf(const Bsp& bsp, const Structs::Vector& point, const int32_t headNode) {
+    const auto leafCount = getLeafCount(bsp);
+    if (bsp.nodes.empty() && leafCount > 0) {
+      return 0;
+    }
+
+    auto child = headNode;
+
+    // A well formed tree can't be deeper than its node count, so bail out rather than spin on a cycle
+    for (size_t depth = 0; child >= 0 && depth <= bsp.nodes.size(); depth++) {
+      if (child >= bsp.nodes.size()) {
+        throw Errors::OutOfBoundsAccess(
+          Enums::Lump::Nodes, std::format("Node index '{}' is out of bounds of the nodes lump", child)
+        );
+      }
+
+      const auto& node = bsp.nodes[child];
+      if (node.planeNum < 0 || node.planeNum >= bsp.planes.size()) {
+        throw Errors::OutOfBoundsAccess(
+          Enums::Lump::Nodes, std::format("Node plane index '{}' is out of bounds of the planes lump", node.planeNum)
+        );
+      }
+
+      const auto& plane = bsp.planes[node.planeNum];
+      const auto distance = dot(plane.normal, point) - plane.distance;
+
+      child = node.children[distance >= 0.f ? 0 : 1];
+    }
+
+    if (child >= 0) {
+      throw Errors::InvalidBody(Enums::Lump::Nodes, "Node tree contains a cycle");
+    }
+
+    const auto leafIndex = static_cast<size_t>(-1 - static_cast<int64_t>(child));
+    if (leafIndex >= leafCount) {
+      throw Errors::OutOfBoundsAccess(
+        Enums::Lump::Nodes, std::format("Node child leaf index '{}' is out of bounds of the leaves lump", leafIndex)
+      );
+    }
+
+    return leafIndex;
+  }
+
+  Enums::Contents getLeafContents(const Bsp& bsp, const size_t leafIndex) {
+    assertLeafValid(bsp, leafIndex);
+
+    return std::visit(
+      [leafIndex](const auto& leaves) { return static_cast<Enums::Contents>(leaves[leafIndex].contents); }, bsp.leaves
+    );
+  }
+
+  const Structs::LeafWaterData* getLeafWaterData(const Bsp& bsp, const size_t leafIndex) {
+    assertLeafValid(bsp, leafIndex);
+
+    return std::visit([&](const auto& leaves) { return getWaterData(bsp, leaves[leafIndex]); }, bsp.leaves);
+  }
+
+  WaterSample sampleWater(const Bsp& bsp, const Structs::Vector& point) {
+    return std::visit([&](const auto& leaves) { return sampleLeafWater(bsp, leaves, point); }, bsp.leaves);
+  }
+
+  void sampleWater(
+    const Bsp& bsp, const std::span<const Structs::Vector> points, const std::span<WaterSample> samples
+  ) {
+    if (samples.size() < points.size()) {
+      throw std::invalid_argument("Water samples must have an entry for every point");
+    }
+
+    std::visit(
+      [&](const auto& leaves) {
+        for (size_t i = 0; i < points.size(); i++) {
+          samples[i] = sampleLeafWater(bsp, leaves, points[i]);
+        }
+      },
+      bsp.leaves
+    );
+  }
+}
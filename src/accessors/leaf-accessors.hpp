@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include "../enums/contents.hpp"
+#include <limits>
+#include <span>
+
+namespace BspParser::Accessors {
+  /**
+   * Water state at a point, as found by sampleWater.
+   */
+  struct WaterSample {
+    /**
+     * Index of the leaf containing the point.
+     */
+    uint32_t leafIndex = 0;
+
+    /**
+     * Whether the point's leaf is inside water or slime.
+     */
+    bool isUnderwater = false;
+
+    /**
+     * World space Z of the water surface, or NaN if the leaf isn't in water.
+     */
+    float surfaceZ = std::numeric_limits<float>::quiet_NaN();
+
+    /**
+     * Compiled distance from the point's leaf to the nearest water, 0 if in water,
+     * or infinity if the BSP wasn't compiled with it.
+     */
+    float minDistanceToWater = 0.f;
+  };
+
+  /**
+   * Returns the number of leaves in the BSP, regardless of the leaf lump version.
+   * @param bsp BSP instance.
+   * @return Number of leaves.
+   */
+  size_t getLeafCount(const Bsp& bsp);
+
+  /**
+   * Walks the BSP tree to find the leaf containing a point.
+   * @param bsp BSP instance.
+   * @param point World space position.
+   * @param headNode Node to start from, e.g. a brush model's headNode. Defaults to the world's root node.
+   * @return Index of the leaf containing the point.
+   * @throws Errors::OutOfBoundsAccess A node, plane or leaf index in the tree is out of bounds.
+   */
+  size_t findLeaf(const Bsp& bsp, const Structs::Vector& point, int32_t headNode = 0);
+
+  /**
+   * Returns the contents of a leaf, regardless of the leaf lump version.
+   * @throws std::out_of_range The leaf doesn't exist.
+   */
+  Enums::Contents getLeafContents(const Bsp& bsp, size_t leafIndex);
+
+  /**
+   * Returns the water volume a leaf is part of.
+   * @return The leaf's water data, or nullptr if it isn't in water.
+   * @throws std::out_of_range The leaf doesn't exist.
+   * @throws Errors::OutOfBoundsAccess The leaf's water data index is out of bounds.
+   */
+  const Structs::LeafWaterData* getLeafWaterData(const Bsp& bsp, size_t leafIndex);
+
+  /**
+   * Finds whether a point is underwater, the height of the water surface and the distance to the nearest water.
+   * @throws Errors::OutOfBoundsAccess The tree or the point's leaf reference out of bounds data.
+   */
+  WaterSample sampleWater(const Bsp& bsp, const Structs::Vector& point);
+
+  /**
+   * Batched sampleWater, which resolves the leaf lump version once and doesn't allocate.
+   * @param samples Receives a sample per point. Must be at least points.size() long.
+   * @throws std::invalid_argument samples is shorter than points.
+   * @throws Errors::OutOfBoundsAccess The tree or a point's leaf reference out of bounds data.
+   */
+  void sampleWater(const Bsp& bsp, std::span<const Structs::Vector> points, std::span<WaterSample> samples);
+}
@@ -0,0 +1,61 @@
+#include "lightmap-accessors.hpp"
+
+namespace BspParser::Accessors {
+  namespace {
+    constexpr uint8_t NO_LIGHT_STYLE = 255;
+  }
+
+  size_t getLightmapSampleCount(const Structs::Face& face) {
+    const auto width = static_cast<size_t>(std::max(face.lightmapTextureSizeInLuxels[0], 0)) + 1;
+    const auto height = static_cast<size_t>(std::max(face.lightmapTextureSizeInLuxels[1], 0)) + 1;
+
+    return width * height;
+  }
+
+  size_t getLightmapsPerStyle(const Structs::TexInfo& textureInfo) {
+    return (textureInfo.flags & Enums::Surface::BumpLight) != Enums::Surface::None ? 1 + Limits::NUM_BUMP_VECTS : 1;
+  }
+
+  std::span<const Structs::ColourRgbExp32> getFaceLightmapSamples(
+    const Bsp& bsp, const size_t faceIndex, const size_t styleIndex, const bool preferHdr
+  ) {
+    if (faceIndex >= bsp.faces.size()) {
+      throw Errors::OutOfBoundsAccess(
+        Enums::Lump::Faces, std::format("Face index '{}' is out of bounds of the faces lump", faceIndex)
+      );
+    }
+
+    const auto useHdrLighting = preferHdr && !bsp.lightingHdr.empty();
+    const auto useHdrFaces = preferHdr && bsp.facesHdr.size() == bsp.faces.size();
+
+    const auto& face = useHdrFaces ? bsp.facesHdr[faceIndex] : bsp.faces[faceIndex];
+    const auto lightingLump = useHdrLighting ? Enums::Lump::LightingHdr : Enums::Lump::Lighting;
+    const auto samples = useHdrLighting ? bsp.lightingHdr : bsp.lighting;
+
+    if (styleIndex >= Limits::MAX_LIGHTMAPS || face.styles[styleIndex] == NO_LIGHT_STYLE || face.lightOffset < 0) {
+      return {};
+    }
+
+    if (face.texInfo < 0 || face.texInfo >= bsp.textureInfos.size()) {
+      throw Errors::OutOfBoundsAccess(
+        Enums::Lump::Faces,
+        std::format("Face texture info index '{}' is out of bounds of the texture info lump", face.texInfo)
+      );
+    }
+
+    const auto samplesPerStyle = getLightmapSampleCount(face) * getLightmapsPerStyle(bsp.textureInfos[face.texInfo]);
+
+    // Light offsets are in bytes rather than samples
+    const auto firstSample = face.lightOffset / sizeof(Structs::ColourRgbExp32) + styleIndex * samplesPerStyle;
+    if (firstSample + samplesPerStyle > samples.size()) {
+      throw Errors::OutOfBoundsAccess(
+        lightingLump,
+        std::format(
+          "Face lightmap ({} + {}) overruns the lighting lump ({})", firstSample, samplesPerStyle, samples.size()
+        )
+      );
+    }
+
+    return samples.subspan(firstSample, samplesPerStyle);
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include <span>
+
+namespace BspParser::Accessors {
+  /**
+   * Returns the number of luxels in a single lightmap of the face.
+   * @param face Face to get the luxel count of.
+   * @return Width * height of the face's lightmap in luxels.
+   */
+  size_t getLightmapSampleCount(const Structs::Face& face);
+
+  /**
+   * Returns the number of lightmaps stored for each of a face's light styles.
+   * Bump-lit surfaces store one lightmap for the flat normal followed by one per bump basis vector.
+   * @param textureInfo Texture info referenced by the face.
+   * @return 1, or 1 + Limits::NUM_BUMP_VECTS for bump-lit surfaces.
+   */
+  size_t getLightmapsPerStyle(const Structs::TexInfo& textureInfo);
+
+  /**
+   * Returns the raw lightmap samples of a face for one of its light styles, without copying.
+   * Uses the HDR lumps (FacesHdr and LightingHdr) when they are present and preferHdr is set, mirroring the engine.
+   * @param bsp BSP instance.
+   * @param faceIndex Index of the face in the faces lump.
+   * @param styleIndex Which of the face's light styles to return (0 to Limits::MAX_LIGHTMAPS - 1).
+   * @param preferHdr Whether to use the HDR lumps when available.
+   * @return getLightmapsPerStyle consecutive row-major lightmaps of getLightmapSampleCount samples each,
+   * or an empty span if the face has no lightmap for the style.
+   * @throws Errors::OutOfBoundsAccess Face index or the face's lightmap is out of bounds.
+   */
+  std::span<const Structs::ColourRgbExp32> getFaceLightmapSamples(
+    const Bsp& bsp, size_t faceIndex, size_t styleIndex, bool preferHdr = true
+  );
+}
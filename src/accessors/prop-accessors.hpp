@@ -14,6 +14,7 @@ namespace BspParser::Accessors {
 
   /**
    * Calls the provided visitor for each static prop in the given BSP.
+   * @note Bsp::staticPropTable exposes the same props without dispatching on the lump version, which suits hot loops better.
    * @tparam Iteratee Visitor type declaring an overload for each supported static prop version.
    * @param bsp BSP instance to iterate.
    * @param iteratee Instance of Iteratee.
@@ -1,6 +1,12 @@
 #include "bsp.hpp"
 #include "displacements/normal-blending.hpp"
+#include "entities/parse-entities.hpp"
+#include "helpers/get-vertex-position.hpp"
+#include "helpers/vector-maths.hpp"
+#include "lighting/nearest-cubemaps.hpp"
 #include "structs/physics.hpp"
+#include <algorithm>
+#include <stdexcept>
 
 namespace BspParser {
   using namespace BspParser::Internal;
@@ -30,11 +36,66 @@ namespace BspParser {
 
     gameLumps = parseGameLumpHeaders();
 
+    entities = parseEntities(parseLump<char>(Enums::Lump::Entities));
+    entitiesByClassName = indexEntitiesByKey(entities, "classname");
+    entitiesByTargetName = indexEntitiesByKey(entities, "targetname");
+
     vertices = parseLump<Structs::Vector>(Enums::Lump::Vertices, Limits::MAX_MAP_VERTS);
     planes = parseLump<Structs::Plane>(Enums::Lump::Planes, Limits::MAX_MAP_PLANES);
     edges = parseLump<Structs::Edge>(Enums::Lump::Edges, Limits::MAX_MAP_EDGES);
     surfaceEdges = parseLump<int32_t>(Enums::Lump::SurfaceEdges, Limits::MAX_MAP_SURFEDGES);
     faces = parseLump<Structs::Face>(Enums::Lump::Faces, Limits::MAX_MAP_FACES);
+    facesHdr = parseLump<Structs::Face>(Enums::Lump::FacesHdr, Limits::MAX_MAP_FACES);
+
+    vertexNormals = parseLump<Structs::Vector>(Enums::Lump::VertexNormals, Limits::MAX_MAP_VERTNORMALS);
+    vertexNormalIndices = parseLump<uint16_t>(Enums::Lump::VertexNormalIndices, Limits::MAX_MAP_VERTNORMALINDICES);
+
+    faceFirstVertexNormals.reserve(faces.size());
+    uint32_t numFaceVertexNormals = 0;
+    for (const auto& face : faces) {
+      faceFirstVertexNormals.push_back(numFaceVertexNormals);
+      numFaceVertexNormals += static_cast<uint32_t>(std::max<int16_t>(face.numEdges, 0));
+    }
+
+    constexpr auto maxLightingSamples = Limits::MAX_MAP_LIGHTING / sizeof(Structs::ColourRgbExp32);
+    lighting = parseLump<Structs::ColourRgbExp32>(Enums::Lump::Lighting, maxLightingSamples);
+    lightingHdr = parseLump<Structs::ColourRgbExp32>(Enums::Lump::LightingHdr, maxLightingSamples);
+
+    primitives = parseLump<Structs::Primitive>(Enums::Lump::Primitives, Limits::MAX_MAP_PRIMITIVES);
+    primitiveVertices = parseLump<Structs::Vector>(Enums::Lump::PrimitiveVertices, Limits::MAX_MAP_PRIMVERTS);
+    primitiveIndices = parseLump<uint16_t>(Enums::Lump::PrimitiveIndices, Limits::MAX_MAP_PRIMINDICES);
+
+    nodes = parseLump<Structs::Node>(Enums::Lump::Nodes, Limits::MAX_MAP_NODES);
+    leaves = parseLeafLump();
+    leafWaterData = parseLump<Structs::LeafWaterData>(Enums::Lump::LeafWaterData, Limits::MAX_MAP_LEAFWATERDATA);
+    leafMinDistancesToWater = parseLump<uint16_t>(Enums::Lump::LeafMinDistanceToWater, Limits::MAX_MAP_LEAFS);
+
+    leafAmbientIndices = parseLump<Structs::LeafAmbientIndex>(Enums::Lump::LeafAmbientIndex, Limits::MAX_MAP_LEAFS);
+    leafAmbientIndicesHdr =
+      parseLump<Structs::LeafAmbientIndex>(Enums::Lump::LeafAmbientIndexHdr, Limits::MAX_MAP_LEAFS);
+    leafAmbientLighting = parseLump<Structs::LeafAmbientLighting>(
+      Enums::Lump::LeafAmbientLighting, Limits::MAX_MAP_LEAF_AMBIENT_SAMPLES
+    );
+    leafAmbientLightingHdr = parseLump<Structs::LeafAmbientLighting>(
+      Enums::Lump::LeafAmbientLightingHdr, Limits::MAX_MAP_LEAF_AMBIENT_SAMPLES
+    );
+
+    worldLights = parseWorldLightLump(Enums::Lump::WorldLights);
+    worldLightsHdr = parseWorldLightLump(Enums::Lump::WorldLightsHdr);
+
+    areas = parseLump<Structs::Area>(Enums::Lump::Areas, Limits::MAX_MAP_AREAS);
+    areaPortals = parseLump<Structs::AreaPortal>(Enums::Lump::AreaPortals, Limits::MAX_MAP_AREAPORTALS);
+    clipPortalVertices = parseLump<Structs::Vector>(Enums::Lump::ClipPortalVertices, Limits::MAX_MAP_PORTALVERTS);
+
+    cubemaps = parseLump<Structs::CubemapSample>(Enums::Lump::Cubemaps, Limits::MAX_MAP_CUBEMAPSAMPLES);
+
+    parseOcclusionLump();
+
+    overlays = parseLump<Structs::Overlay>(Enums::Lump::Overlays, Limits::MAX_MAP_OVERLAYS);
+    waterOverlays = parseLump<Structs::WaterOverlay>(Enums::Lump::WaterOverlays, Limits::MAX_MAP_WATEROVERLAYS);
+    overlayFades = parseLump<Structs::OverlayFade>(Enums::Lump::OverlayFades, Limits::MAX_MAP_OVERLAYS);
+    overlaySystemLevels =
+      parseLump<Structs::OverlaySystemLevel>(Enums::Lump::OverlaySystemLevels, Limits::MAX_MAP_OVERLAYS);
 
     textureInfos = parseLump<Structs::TexInfo>(Enums::Lump::TextureInfo, Limits::MAX_MAP_TEXINFO);
     textureDatas = parseLump<Structs::TexData>(Enums::Lump::TextureData, Limits::MAX_MAP_TEXDATA);
@@ -45,20 +106,33 @@ namespace BspParser {
 
     displacementInfos = parseLump<Structs::DispInfo>(Enums::Lump::DisplacementInfo, Limits::MAX_MAP_DISPINFO);
     displacementVertices = parseLump<Structs::DispVert>(Enums::Lump::DisplacementVertices, Limits::MAX_MAP_DISP_VERTS);
+    displacementTriangles =
+      parseLump<Structs::DispTri>(Enums::Lump::DisplacementTriangles, Limits::MAX_MAP_DISP_TRIANGLES);
+    physicsDisplacements = parsePhysDisplacementsLump();
 
     displacements.reserve(displacementInfos.size());
     for (const auto& displacementInfo : displacementInfos) {
-      displacements.push_back(createTriangulatedDisplacement(displacementInfo));
+      displacements.push_back(createTriangulatedDisplacement(displacementInfo, displacementVertices));
     }
 
     physicsModels = parsePhysCollideLump();
+    indexPhysicsModels();
 
     compressedPakfile = parsePakfileLump();
 
     for (const auto& gameLump : gameLumps) {
       switch (gameLump.id) {
         case Enums::GameLumpID::DetailProps:
-          // TODO: Implement parsing for detail props
+          if (gameLump.version == 4) {
+            parseDetailPropLump(gameLump);
+          }
+          // TODO: Raise a warning for unsupported detail prop lumps
+          break;
+        case Enums::GameLumpID::DetailPropLighting:
+          detailPropLightStyles = parseDetailPropLightingLump(gameLump);
+          break;
+        case Enums::GameLumpID::DetailPropLightingHdr:
+          detailPropLightStylesHdr = parseDetailPropLightingLump(gameLump);
           break;
         case Enums::GameLumpID::StaticProps:
           switch (gameLump.version) {
@@ -88,10 +162,138 @@ namespace BspParser {
           break;
       }
     }
+
+    if (staticProps.has_value() && staticPropDictionary.has_value() && staticPropLeaves.has_value()) {
+      staticPropTable = StaticPropTable(staticPropDictionary.value(), staticPropLeaves.value(), staticProps.value());
+    }
+
+    if (detailObjects.has_value()) {
+      detailPropTable = DetailPropTable(detailObjects.value());
+    }
   }
 
   void Bsp::smoothNeighbouringDisplacements() {
     blendNeighbouringDisplacementNormals(displacements);
+    displacementsSmoothed = true;
+  }
+
+  void Bsp::updateDisplacements(
+    const std::span<const uint32_t> displacementIndices, const std::span<const Structs::DispVert> dispVertices
+  ) {
+    size_t numVertices = 0;
+    for (const auto displacementIndex : displacementIndices) {
+      if (displacementIndex >= displacements.size()) {
+        throw std::out_of_range(
+          std::format("Displacement '{}' is out of bounds of the displacements", displacementIndex)
+        );
+      }
+
+      numVertices += displacements[displacementIndex].vertices.size();
+    }
+
+    if (dispVertices.size() != numVertices) {
+      throw std::invalid_argument(
+        std::format("Edited displacements have {} vertices, but {} were given", numVertices, dispVertices.size())
+      );
+    }
+
+    size_t firstVertex = 0;
+    for (const auto displacementIndex : displacementIndices) {
+      auto& displacement = displacements[displacementIndex];
+      const auto numDisplacementVertices = displacement.vertices.size();
+
+      // Triangulated from the start of its new vertices, then given back its original offset into the lump
+      auto displacementInfo = displacement.dispInfo;
+      displacementInfo.dispVertStart = 0;
+
+      displacement =
+        createTriangulatedDisplacement(displacementInfo, dispVertices.subspan(firstVertex, numDisplacementVertices));
+      displacement.dispInfo.dispVertStart = displacementInfos[displacementIndex].dispVertStart;
+
+      firstVertex += numDisplacementVertices;
+    }
+
+    if (displacementsSmoothed) {
+      reblendDisplacementNormals(displacements, displacementIndices);
+    }
+  }
+
+  LeafLump Bsp::parseLeafLump() {
+    const auto version = header->lumps.at(static_cast<size_t>(Enums::Lump::Leaves)).version;
+
+    switch (version) {
+      case 0:
+        return parseLump<Structs::LeafV0>(Enums::Lump::Leaves, Limits::MAX_MAP_LEAFS);
+      case 1:
+        return parseLump<Structs::LeafV1>(Enums::Lump::Leaves, Limits::MAX_MAP_LEAFS);
+      default:
+        throw Errors::UnsupportedVersion(Enums::Lump::Leaves, std::format("Unsupported leaf lump version {}", version));
+    }
+  }
+
+  WorldLightLump Bsp::parseWorldLightLump(const Enums::Lump lump) {
+    const auto version = header->lumps.at(static_cast<size_t>(lump)).version;
+
+    switch (version) {
+      case 0:
+        return parseLump<Structs::WorldLightV0>(lump, Limits::MAX_MAP_WORLDLIGHTS);
+      case 1:
+        return parseLump<Structs::WorldLightV1>(lump, Limits::MAX_MAP_WORLDLIGHTS);
+      default:
+        throw Errors::UnsupportedVersion(lump, std::format("Unsupported world light lump version {}", version));
+    }
+  }
+
+  void Bsp::parseOcclusionLump() {
+    const auto& lumpHeader = header->lumps.at(static_cast<size_t>(Enums::Lump::Occlusion));
+    assertLumpHeaderValid(Enums::Lump::Occlusion, lumpHeader);
+
+    // Maps without func_occluders may omit the lump entirely
+    if (lumpHeader.length == 0) {
+      return;
+    }
+
+    const auto occluderData = OffsetDataView(std::span(&data[lumpHeader.offset], lumpHeader.length));
+    const auto numOccluders = occluderData.parseStruct<int32_t>(
+      0, "Occlusion lump length is shorter than a single int32 for the occluder count"
+    );
+
+    size_t occluderSize;
+    switch (lumpHeader.version) {
+      case 1:
+        occluders = occluderData.parseStructArray<Structs::OccluderDataV1>(
+          sizeof(int32_t), numOccluders, "Occlusion lump occluders overflowed the lump"
+        );
+        occluderSize = sizeof(Structs::OccluderDataV1);
+        break;
+      case 2:
+        occluders = occluderData.parseStructArray<Structs::OccluderDataV2>(
+          sizeof(int32_t), numOccluders, "Occlusion lump occluders overflowed the lump"
+        );
+        occluderSize = sizeof(Structs::OccluderDataV2);
+        break;
+      default:
+        throw Errors::UnsupportedVersion(
+          Enums::Lump::Occlusion, std::format("Unsupported occlusion lump version {}", lumpHeader.version)
+        );
+    }
+
+    const auto polygonData = occluderData.withRelativeOffset(sizeof(int32_t) + numOccluders * occluderSize);
+    const auto numPolygons = polygonData.parseStruct<int32_t>(
+      0, "Occlusion lump length is shorter than its occluders plus a single int32 for the polygon count"
+    );
+    occluderPolygons = polygonData.parseStructArray<Structs::OccluderPolyData>(
+      sizeof(int32_t), numPolygons, "Occlusion lump polygons overflowed the lump"
+    );
+
+    const auto vertexIndexData =
+      polygonData.withRelativeOffset(sizeof(int32_t) + numPolygons * sizeof(Structs::OccluderPolyData));
+    const auto numVertexIndices = vertexIndexData.parseStruct<int32_t>(
+      0, "Occlusion lump length is shorter than its occluders, polygons, and a single int32 for the vertex index count"
+    );
+    occluderVertexIndices = vertexIndexData.parseStructArray<int32_t>(
+      sizeof(int32_t), numVertexIndices, "Occlusion lump vertex indices overflowed the lump"
+    );
   }
 
   std::span<const Structs::GameLump> Bsp::parseGameLumpHeaders() const {
@@ -163,11 +365,48 @@ namespace BspParser {
         );
       }
 
+      const auto collisionData = data.subspan(offset, modelHeader.collisionDataSize);
+
+      if (modelHeader.solidCount < 0) {
+        throw Errors::InvalidBody(
+          Enums::Lump::PhysCollide,
+          std::format("PhysCollide model header has a negative solid count ({})", modelHeader.solidCount)
+        );
+      }
+
+      // Each solid is prefixed with its size, so split them without copying
+      std::vector<std::span<const std::byte>> solids;
+      solids.reserve(modelHeader.solidCount);
+
+      size_t solidOffset = 0;
+      for (int32_t solidIndex = 0; solidIndex < modelHeader.solidCount; solidIndex++) {
+        if (collisionData.size() - solidOffset < sizeof(int32_t)) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::PhysCollide,
+            std::format("PhysCollide model's collision data ends before the size of solid {}", solidIndex)
+          );
+        }
+
+        const auto solidSize = *reinterpret_cast<const int32_t*>(&collisionData[solidOffset]);
+        if (solidSize < 0 || collisionData.size() - solidOffset - sizeof(int32_t) < solidSize) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::PhysCollide,
+            std::format(
+              "PhysCollide model's solid {} has size ({}) exceeding its collision data", solidIndex, solidSize
+            )
+          );
+        }
+
+        solids.push_back(collisionData.subspan(solidOffset, sizeof(int32_t) + solidSize));
+        solidOffset += sizeof(int32_t) + solidSize;
+      }
+
       physicsModels.push_back(
         PhysModel{
           .modelIndex = modelHeader.modelIndex,
           .solidCount = modelHeader.solidCount,
-          .collisionData = data.subspan(offset, modelHeader.collisionDataSize),
+          .collisionData = collisionData,
+          .solids = std::move(solids),
           .textSectionData = data.subspan(offset + modelHeader.collisionDataSize, modelHeader.textSectionSize),
         }
       );
@@ -177,6 +416,100 @@ namespace BspParser {
     return std::move(physicsModels);
   }
 
+  std::vector<std::span<const std::byte>> Bsp::parsePhysDisplacementsLump() const {
+    const auto& lumpHeader = header->lumps.at(static_cast<size_t>(Enums::Lump::PhysDisplacements));
+    assertLumpHeaderValid(Enums::Lump::PhysDisplacements, lumpHeader);
+
+    if (lumpHeader.length == 0) {
+      return {};
+    }
+
+    const auto lumpData = OffsetDataView(std::span(&data[lumpHeader.offset], lumpHeader.length));
+    const auto numDisplacements = lumpData.parseStruct<uint16_t>(
+      0, "PhysDisplacements lump length is shorter than a single uint16 for the displacement count"
+    );
+    const auto dataSizes = lumpData.parseStructArray<uint16_t>(
+      sizeof(uint16_t), numDisplacements, "PhysDisplacements lump data sizes overflowed the lump"
+    );
+
+    std::vector<std::span<const std::byte>> displacementData;
+    displacementData.reserve(numDisplacements);
+
+    auto offset = sizeof(uint16_t) + numDisplacements * sizeof(uint16_t);
+    for (const auto dataSize : dataSizes) {
+      displacementData.push_back(lumpData.parseStructArray<std::byte>(
+        offset, dataSize, "PhysDisplacements lump displacement data overflowed the lump"
+      ));
+      offset += dataSize;
+    }
+
+    return displacementData;
+  }
+
+  void Bsp::indexPhysicsModels() {
+    // Stable so models with several physics models keep their lump order
+    std::ranges::stable_sort(physicsModels, {}, &PhysModel::modelIndex);
+
+    // Physics models for out of range models sort to the end, outside every model's range
+    modelPhysicsModelOffsets.assign(models.size() + 1, 0);
+    for (const auto& physicsModel : physicsModels) {
+      if (physicsModel.modelIndex >= 0 && physicsModel.modelIndex < models.size()) {
+        modelPhysicsModelOffsets[physicsModel.modelIndex + 1]++;
+      }
+    }
+
+    for (size_t modelIndex = 0; modelIndex < models.size(); modelIndex++) {
+      modelPhysicsModelOffsets[modelIndex + 1] += modelPhysicsModelOffsets[modelIndex];
+    }
+  }
+
+  void Bsp::parseDetailPropLump(const Structs::GameLump& lumpHeader) {
+    assertGameLumpHeaderValid(lumpHeader);
+
+    const auto modelDictionaryData = OffsetDataView(std::span(&data[lumpHeader.offset], lumpHeader.length));
+    const auto numModelDictionaryEntries = modelDictionaryData.parseStruct<int32_t>(
+      0, "Detail prop game lump length is shorter than a single int32 for the model dictionary count"
+    );
+    detailObjectDictionary = modelDictionaryData.parseStructArray<Structs::DetailObjectDict>(
+      sizeof(int32_t), numModelDictionaryEntries, "Detail prop game lump model dictionary entries overflowed the lump"
+    );
+
+    const auto spriteDictionaryData = modelDictionaryData.withRelativeOffset(
+      sizeof(int32_t) + numModelDictionaryEntries * sizeof(Structs::DetailObjectDict)
+    );
+    const auto numSpriteDictionaryEntries = spriteDictionaryData.parseStruct<int32_t>(
+      0, "Detail prop game lump length is shorter than its model dictionary plus a single int32 for the sprite count"
+    );
+    detailSpriteDictionary = spriteDictionaryData.parseStructArray<Structs::DetailSpriteDict>(
+      sizeof(int32_t), numSpriteDictionaryEntries, "Detail prop game lump sprite dictionary entries overflowed the lump"
+    );
+
+    const auto objectData = spriteDictionaryData.withRelativeOffset(
+      sizeof(int32_t) + numSpriteDictionaryEntries * sizeof(Structs::DetailSpriteDict)
+    );
+    const auto numObjects = objectData.parseStruct<int32_t>(
+      0, "Detail prop game lump length is shorter than its dictionaries and a single int32 for the object count"
+    );
+    detailObjects = objectData.parseStructArray<Structs::DetailObject>(
+      sizeof(int32_t), numObjects, "Detail prop game lump objects overflowed the lump"
+    );
+  }
+
+  std::span<const Structs::DetailPropLightstyles> Bsp::parseDetailPropLightingLump(
+    const Structs::GameLump& lumpHeader
+  ) const {
+    assertGameLumpHeaderValid(lumpHeader);
+
+    const auto lightingData = OffsetDataView(std::span(&data[lumpHeader.offset], lumpHeader.length));
+    const auto numLightStyles = lightingData.parseStruct<int32_t>(
+      0, "Detail prop lighting game lump length is shorter than a single int32 for the light style count"
+    );
+
+    return lightingData.parseStructArray<Structs::DetailPropLightstyles>(
+      sizeof(int32_t), numLightStyles, "Detail prop lighting game lump light styles overflowed the lump"
+    );
+  }
+
   std::vector<Zip::ZipFileEntry> Bsp::parsePakfileLump() const {
     const auto& lumpHeader = header->lumps.at(static_cast<size_t>(Enums::Lump::PakFile));
     assertLumpHeaderValid(Enums::Lump::PakFile, lumpHeader);
@@ -207,14 +540,102 @@ namespace BspParser {
     }
   }
 
-  TriangulatedDisplacement Bsp::createTriangulatedDisplacement(const Structs::DispInfo& displacementInfo) const {
+  void Bsp::assertGameLumpHeaderValid(const Structs::GameLump& lumpHeader) const {
+    if (lumpHeader.offset < 0) {
+      throw Errors::InvalidBody(
+        Enums::Lump::GameLump, std::format("Game lump header has a negative offset ({})", lumpHeader.offset)
+      );
+    }
+
+    if (lumpHeader.length < 0) {
+      throw Errors::InvalidBody(
+        Enums::Lump::GameLump, std::format("Game lump header has a negative length ({})", lumpHeader.length)
+      );
+    }
+
+    if (lumpHeader.offset + lumpHeader.length > data.size_bytes()) {
+      throw Errors::OutOfBoundsAccess(
+        Enums::Lump::GameLump,
+        std::format(
+          "Game lump header has offset + length ({}) overrunning the file ({})",
+          lumpHeader.offset + lumpHeader.length,
+          data.size_bytes()
+        )
+      );
+    }
+  }
+
+  void Bsp::assignNearestCubemaps() {
+    // Faces, displacements and static props are gathered into one list so they share a single parallel search
+    std::vector<Structs::Vector> positions;
+    positions.reserve(faces.size() + displacements.size() + staticPropTable.size());
+
+    for (const auto& face : faces) {
+      if (face.firstEdge < 0 || face.numEdges < 0 || face.firstEdge + face.numEdges > surfaceEdges.size()) {
+        throw Errors::OutOfBoundsAccess(
+          Enums::Lump::Faces,
+          std::format(
+            "Face's firstEdge + numEdges ({} + {}) is out of bounds of the surf edges lump",
+            face.firstEdge,
+            face.numEdges
+          )
+        );
+      }
+
+      auto centroid = Structs::Vector{};
+      for (const auto surfaceEdge : surfaceEdges.subspan(face.firstEdge, face.numEdges)) {
+        centroid = add(centroid, getVertexPosition(edges, vertices, surfaceEdge));
+      }
+
+      positions.push_back(face.numEdges > 0 ? div(centroid, static_cast<float>(face.numEdges)) : centroid);
+    }
+
+    for (const auto& displacement : displacements) {
+      auto centroid = Structs::Vector{};
+      for (const auto& vertex : displacement.vertices) {
+        centroid = add(centroid, vertex.position);
+      }
+
+      positions.push_back(div(centroid, static_cast<float>(displacement.vertices.size())));
+    }
+
+    for (size_t propIndex = 0; propIndex < staticPropTable.size(); propIndex++) {
+      const auto usesLightingOrigin =
+        (staticPropTable.flags[propIndex] & static_cast<uint32_t>(Enums::StaticPropFlag::UseLightingOrigin)) != 0;
+
+      positions.push_back(
+        usesLightingOrigin ? staticPropTable.lightingOrigins[propIndex] : staticPropTable.origins[propIndex]
+      );
+    }
+
+    std::vector<int32_t> nearestCubemaps(positions.size());
+    findNearestCubemaps(cubemaps, positions, nearestCubemaps);
+
+    const auto firstDisplacement = nearestCubemaps.begin() + static_cast<ptrdiff_t>(faces.size());
+    const auto firstStaticProp = firstDisplacement + static_cast<ptrdiff_t>(displacements.size());
+
+    faceCubemaps.assign(nearestCubemaps.begin(), firstDisplacement);
+    displacementCubemaps.assign(firstDisplacement, firstStaticProp);
+    staticPropCubemaps.assign(firstStaticProp, nearestCubemaps.end());
+  }
+
+  TriangulatedDisplacement Bsp::createTriangulatedDisplacement(
+    const Structs::DispInfo& displacementInfo, const std::span<const Structs::DispVert> dispVertices
+  ) const {
     const auto& face = faces[displacementInfo.mapFace];
     const auto& textureInfo = textureInfos[face.texInfo];
     const auto& textureData = textureDatas[textureInfo.texData];
     const auto surfaceEdgesForDisplacement = surfaceEdges.subspan(face.firstEdge, face.numEdges);
 
     return TriangulatedDisplacement(
-      displacementInfo, displacementVertices, edges, vertices, surfaceEdgesForDisplacement, textureInfo, textureData
+      displacementInfo,
+      dispVertices,
+      edges,
+      vertices,
+      surfaceEdgesForDisplacement,
+      face,
+      textureInfo,
+      textureData
     );
   }
 }
@@ -2,27 +2,44 @@
 
 #include "errors.hpp"
 #include "phys-model.hpp"
+#include "detail-props/detail-prop-table.hpp"
 #include "displacements/triangulated-displacement.hpp"
+#include "entities/entity.hpp"
 #include "enums/lump.hpp"
 #include "helpers/offset-data-view.hpp"
 #include "helpers/zip.hpp"
+#include "static-props/static-prop-table.hpp"
+#include "structs/areas.hpp"
 #include "structs/common.hpp"
 #include "structs/detail-props.hpp"
 #include "structs/displacements.hpp"
 #include "structs/geometry.hpp"
 #include "structs/headers.hpp"
+#include "structs/lighting.hpp"
 #include "structs/models.hpp"
+#include "structs/occlusion.hpp"
+#include "structs/overlays.hpp"
 #include "structs/static-props.hpp"
 #include "structs/textures.hpp"
+#include "structs/tree.hpp"
 #include <format>
 #include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
 namespace BspParser {
+  using LeafLump = std::variant<std::span<const Structs::LeafV0>, std::span<const Structs::LeafV1>>;
+  using WorldLightLump = std::variant<std::span<const Structs::WorldLightV0>, std::span<const Structs::WorldLightV1>>;
+  using OccluderLump =
+    std::variant<std::span<const Structs::OccluderDataV1>, std::span<const Structs::OccluderDataV2>>;
+
   /**
-   * Lightweight abstraction over a BSP file, providing direct access to many of its lumps without any additional allocations.
+   * Lightweight abstraction over a BSP file, providing direct access to many of its lumps without copying them.
+   * Cheap derived data like entities, triangulated displacements and prop tables is built on construction, while more
+   * expensive work like displacement smoothing and cubemap assignment is left to be opted into.
    *
    * @note Does not take ownership of the passed data. It is your responsibility to ensure the lifetime of the BSP does not exceed that of the underlying data.
    */
@@ -35,12 +52,107 @@ namespace BspParser {
 
     std::span<const Structs::GameLump> gameLumps;
 
+    /**
+     * Entities parsed from the entity lump. Keys and values are views into the BSP data.
+     */
+    std::vector<Entity> entities;
+
+    /**
+     * Indices into entities grouped by classname.
+     */
+    std::unordered_map<std::string_view, std::vector<size_t>> entitiesByClassName;
+
+    /**
+     * Indices into entities grouped by targetname. Entities without a targetname are not included.
+     */
+    std::unordered_map<std::string_view, std::vector<size_t>> entitiesByTargetName;
+
     std::span<const Structs::Vector> vertices;
     std::span<const Structs::Plane> planes;
     std::span<const Structs::Edge> edges;
     std::span<const int32_t> surfaceEdges;
     std::span<const Structs::Face> faces;
 
+    /**
+     * Smoothed vertex normals compiled by VRAD, referenced through vertexNormalIndices.
+     */
+    std::span<const Structs::Vector> vertexNormals;
+    std::span<const uint16_t> vertexNormalIndices;
+
+    /**
+     * Index into vertexNormalIndices of each face's first vertex normal.
+     * Faces take one normal index per edge, in lump order.
+     */
+    std::vector<uint32_t> faceFirstVertexNormals;
+
+    std::span<const Structs::Primitive> primitives;
+    std::span<const Structs::Vector> primitiveVertices;
+    std::span<const uint16_t> primitiveIndices;
+
+    std::span<const Structs::Node> nodes;
+
+    /**
+     * Leaves in either lump version. Version 0 leaves embed their ambient lighting.
+     */
+    LeafLump leaves;
+
+    std::span<const Structs::LeafWaterData> leafWaterData;
+
+    /**
+     * Distance in units from each leaf to the nearest water, saturating at 65535. Empty for BSPs compiled without it.
+     */
+    std::span<const uint16_t> leafMinDistancesToWater;
+
+    /**
+     * HDR copies of the faces, differing only in their light offsets. Empty for maps compiled without HDR lighting.
+     */
+    std::span<const Structs::Face> facesHdr;
+
+    std::span<const Structs::ColourRgbExp32> lighting;
+    std::span<const Structs::ColourRgbExp32> lightingHdr;
+
+    std::span<const Structs::LeafAmbientIndex> leafAmbientIndices;
+    std::span<const Structs::LeafAmbientIndex> leafAmbientIndicesHdr;
+    std::span<const Structs::LeafAmbientLighting> leafAmbientLighting;
+    std::span<const Structs::LeafAmbientLighting> leafAmbientLightingHdr;
+
+    WorldLightLump worldLights;
+    WorldLightLump worldLightsHdr;
+
+    std::span<const Structs::Area> areas;
+    std::span<const Structs::AreaPortal> areaPortals;
+
+    /**
+     * Polygons of each area portal, referenced by their first vertex and vertex count.
+     */
+    std::span<const Structs::Vector> clipPortalVertices;
+
+    std::span<const Structs::CubemapSample> cubemaps;
+
+    /**
+     * func_occluder brushes in either lump version. Version 2 occluders record their area.
+     */
+    OccluderLump occluders;
+    std::span<const Structs::OccluderPolyData> occluderPolygons;
+
+    /**
+     * Indices into vertices for each occluder polygon.
+     */
+    std::span<const int32_t> occluderVertexIndices;
+
+    std::span<const Structs::Overlay> overlays;
+    std::span<const Structs::WaterOverlay> waterOverlays;
+
+    /**
+     * Fade distances for each overlay. Empty for BSPs without overlay fades.
+     */
+    std::span<const Structs::OverlayFade> overlayFades;
+
+    /**
+     * CPU and GPU levels each overlay is visible at. Empty for BSPs without overlay system levels.
+     */
+    std::span<const Structs::OverlaySystemLevel> overlaySystemLevels;
+
     std::span<const Structs::TexInfo> textureInfos;
     std::span<const Structs::TexData> textureDatas;
     std::span<const int32_t> textureStringTable;
@@ -51,35 +163,105 @@ namespace BspParser {
     std::span<const Structs::DispInfo> displacementInfos;
     std::span<const Structs::DispVert> displacementVertices;
 
+    /**
+     * Collision tags for every displacement triangle, indexed from each displacement's dispTriStart.
+     */
+    std::span<const Structs::DispTri> displacementTriangles;
+
+    /**
+     * Serialised physics collision data of each displacement, indexed the same as displacementInfos.
+     * Empty if the BSP has no physics displacement lump.
+     */
+    std::vector<std::span<const std::byte>> physicsDisplacements;
+
     /**
      * Triangulated and internally smoothed displacement infos for rendering.
      * @note Use smoothNeighbouringDisplacements to smooth the normals and tangents between connected displacements, which mutates this collection.
      */
     std::vector<TriangulatedDisplacement> displacements;
 
+    /**
+     * Index of the cubemap nearest to each face's centroid, or -1 if the BSP has no cubemaps.
+     * @note Empty until assignNearestCubemaps is called.
+     */
+    std::vector<int32_t> faceCubemaps;
+
+    /**
+     * Index of the cubemap nearest to the centroid of each displaced surface in displacements, or -1 if none.
+     * @note Empty until assignNearestCubemaps is called.
+     */
+    std::vector<int32_t> displacementCubemaps;
+
+    /**
+     * Physics models sorted by model index.
+     */
     std::vector<PhysModel> physicsModels;
 
+    /**
+     * Offsets into physicsModels for each model in models, plus a final end offset.
+     */
+    std::vector<uint32_t> modelPhysicsModelOffsets;
+
     std::vector<Zip::ZipFileEntry> compressedPakfile;
 
-    // std::span<const Structs::DetailObjectDict> detailObjectDictionary;
-    // std::span<const Structs::DetailObject> detailObjects;
+    std::optional<std::span<const Structs::DetailObjectDict>> detailObjectDictionary = std::nullopt;
+    std::optional<std::span<const Structs::DetailSpriteDict>> detailSpriteDictionary = std::nullopt;
+    std::optional<std::span<const Structs::DetailObject>> detailObjects = std::nullopt;
+
+    std::optional<std::span<const Structs::DetailPropLightstyles>> detailPropLightStyles = std::nullopt;
+    std::optional<std::span<const Structs::DetailPropLightstyles>> detailPropLightStylesHdr = std::nullopt;
+
+    /**
+     * Detail props split by model and sprite type into structures of arrays, sorted by leaf.
+     * @note Empty if the BSP has no supported detail prop lump.
+     */
+    DetailPropTable detailPropTable;
 
     std::optional<std::span<const Structs::StaticPropDict>> staticPropDictionary = std::nullopt;
     std::optional<std::span<const Structs::StaticPropLeaf>> staticPropLeaves = std::nullopt;
 
-    std::optional<std::variant<
-      std::span<const Structs::StaticPropV4>,
-      std::span<const Structs::StaticPropV5>,
-      std::span<const Structs::StaticPropV6>,
-      std::span<const Structs::StaticPropV7Multiplayer2013>>>
-      staticProps = std::nullopt;
+    std::optional<StaticPropLump> staticProps = std::nullopt;
+
+    /**
+     * Static props normalised into a structure of arrays, independent of the lump version.
+     * @note Empty if the BSP has no supported static prop lump.
+     */
+    StaticPropTable staticPropTable;
+
+    /**
+     * Index of the cubemap nearest to each prop in staticPropTable, using its lighting origin where it has one,
+     * or -1 if the BSP has no cubemaps.
+     * @note Empty until assignNearestCubemaps is called.
+     */
+    std::vector<int32_t> staticPropCubemaps;
 
     /**
      * Smooths normals and tangents between neighbouring displacements for rendering.
-     * @warning This must only be called once.
+     * Calling this again redoes the smoothing from the unsmoothed normals, rather than smoothing twice.
      */
     void smoothNeighbouringDisplacements();
 
+    /**
+     * Re-triangulates displacements from edited vertex data without reparsing the BSP, such as for a map editor's
+     * preview. Once displacements have been smoothed, only the edited displacements and their neighbours are smoothed
+     * again, and repeating an update gives the same result.
+     * @param displacementIndices Indices into displacements of the edited displacements.
+     * @param dispVertices New vertices of each edited displacement in turn, as many for each as it has vertices.
+     * @throws std::out_of_range A displacement index is out of bounds.
+     * @throws std::invalid_argument The number of vertices doesn't match the edited displacements.
+     * @note Only displacements are updated, not data derived from them like displacementCubemaps.
+     */
+    void updateDisplacements(
+      std::span<const uint32_t> displacementIndices, std::span<const Structs::DispVert> dispVertices
+    );
+
+    /**
+     * Fills faceCubemaps, displacementCubemaps and staticPropCubemaps with the nearest cubemap to each, searching
+     * across threads.
+     * @throws Errors::OutOfBoundsAccess A face's surface edges are out of bounds of the surf edges lump.
+     */
+    void assignNearestCubemaps();
+
   private:
     template <typename LumpType>
     std::span<const LumpType> parseLump(Enums::Lump lump, size_t maxItems = std::numeric_limits<size_t>::max()) {
@@ -110,34 +292,21 @@ namespace BspParser {
 
     [[nodiscard]] std::span<const Structs::GameLump> parseGameLumpHeaders() const;
 
+    [[nodiscard]] LeafLump parseLeafLump();
+
+    [[nodiscard]] WorldLightLump parseWorldLightLump(Enums::Lump lump);
+
+    void parseOcclusionLump();
+
     [[nodiscard]] std::vector<PhysModel> parsePhysCollideLump() const;
 
-    template <class StaticProp>
-    [[nodiscard]] std::span<const StaticProp> parseStaticPropLump(const Structs::GameLump& lumpHeader) {
-      if (lumpHeader.offset < 0) {
-        throw Errors::InvalidBody(
-          Enums::Lump::GameLump,
-          std::format("Static prop game lump header has a negative offset ({})", lumpHeader.offset)
-        );
-      }
+    void indexPhysicsModels();
 
-      if (lumpHeader.length < 0) {
-        throw Errors::InvalidBody(
-          Enums::Lump::GameLump,
-          std::format("Static prop game lump header has a negative length ({})", lumpHeader.length)
-        );
-      }
+    [[nodiscard]] std::vector<std::span<const std::byte>> parsePhysDisplacementsLump() const;
 
-      if (lumpHeader.offset + lumpHeader.length > data.size_bytes()) {
-        throw Errors::OutOfBoundsAccess(
-          Enums::Lump::GameLump,
-          std::format(
-            "Static prop game lump header has offset + length ({}) overrunning the file ({})",
-            lumpHeader.offset + lumpHeader.length,
-            data.size_bytes()
-          )
-        );
-      }
+    template <class StaticProp>
+    [[nodiscard]] std::span<const StaticProp> parseStaticPropLump(const Structs::GameLump& lumpHeader) {
+      assertGameLumpHeaderValid(lumpHeader);
 
       const auto dictionaryData = Internal::OffsetDataView(std::span(&data[lumpHeader.offset], lumpHeader.length));
       const auto numDictionaryEntries = dictionaryData.parseStruct<int32_t>(
@@ -167,12 +336,22 @@ namespace BspParser {
       return props;
     }
 
+    void parseDetailPropLump(const Structs::GameLump& lumpHeader);
+
+    [[nodiscard]] std::span<const Structs::DetailPropLightstyles> parseDetailPropLightingLump(
+      const Structs::GameLump& lumpHeader
+    ) const;
+
     [[nodiscard]] std::vector<Zip::ZipFileEntry> parsePakfileLump() const;
 
     void assertLumpHeaderValid(Enums::Lump lump, const Structs::Lump& lumpHeader) const;
 
+    void assertGameLumpHeaderValid(const Structs::GameLump& lumpHeader) const;
+
+    bool displacementsSmoothed = false;
+
     [[nodiscard]] TriangulatedDisplacement createTriangulatedDisplacement(
-      const Structs::DispInfo& displacementInfo
+      const Structs::DispInfo& displacementInfo, std::span<const Structs::DispVert> dispVertices
     ) const;
   };
 }
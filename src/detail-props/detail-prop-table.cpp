@@ -0,0 +1,95 @@
+#include "detail-prop-table.hpp"
+#include <algorithm>
+
+namespace BspParser {
+  namespace {
+    bool isModel(const Structs::DetailObject& detailObject) {
+      return detailObject.type == Enums::DetailPropType::Model;
+    }
+
+    void buildGroup(
+      DetailPropGroup& group, const std::span<const Structs::DetailObject> detailObjects, const bool models
+    ) {
+      // Counting sort by leaf, preserving lump order within each leaf
+      uint16_t maxLeaf = 0;
+      for (const auto& detailObject : detailObjects) {
+        if (isModel(detailObject) == models) {
+          maxLeaf = std::max(maxLeaf, detailObject.leaf);
+        }
+      }
+
+      group.leafOffsets.assign(static_cast<size_t>(maxLeaf) + 2, 0);
+      for (const auto& detailObject : detailObjects) {
+        if (isModel(detailObject) == models) {
+          group.leafOffsets[detailObject.leaf + 1]++;
+        }
+      }
+
+      for (size_t leaf = 0; leaf <= maxLeaf; leaf++) {
+        group.leafOffsets[leaf + 1] += group.leafOffsets[leaf];
+      }
+
+      const auto count = group.leafOffsets.back();
+      if (count == 0) {
+        group.leafOffsets.clear();
+        return;
+      }
+
+      group.lumpIndices.resize(count);
+      group.origins.resize(count);
+      group.angles.resize(count);
+      group.dictionaryIndices.resize(count);
+      group.leaves.resize(count);
+      group.lighting.resize(count);
+      group.firstLightStyles.resize(count);
+      group.lightStyleCounts.resize(count);
+      group.swayAmounts.resize(count);
+      group.orientations.resize(count);
+      group.types.resize(count);
+      group.shapeAngles.resize(count);
+      group.shapeSizes.resize(count);
+      group.scales.resize(count);
+
+      auto cursors = std::vector(group.leafOffsets.begin(), group.leafOffsets.end() - 1);
+      for (uint32_t lumpIndex = 0; lumpIndex < detailObjects.size(); lumpIndex++) {
+        const auto& detailObject = detailObjects[lumpIndex];
+        if (isModel(detailObject) != models) {
+          continue;
+        }
+
+        const auto index = cursors[detailObject.leaf]++;
+        group.lumpIndices[index] = lumpIndex;
+        group.origins[index] = detailObject.origin;
+        group.angles[index] = detailObject.angles;
+        group.dictionaryIndices[index] = detailObject.detailModel;
+        group.leaves[index] = detailObject.leaf;
+        group.lighting[index] = detailObject.lighting;
+        group.firstLightStyles[index] = detailObject.lightStyles;
+        group.lightStyleCounts[index] = detailObject.lightStyleCount;
+        group.swayAmounts[index] = detailObject.swayAmount;
+        group.orientations[index] = detailObject.orientation;
+        group.types[index] = detailObject.type;
+        group.shapeAngles[index] = detailObject.shapeAngle;
+        group.shapeSizes[index] = detailObject.shapeSize;
+        group.scales[index] = detailObject.flScale;
+      }
+    }
+  }
+
+  std::pair<size_t, size_t> DetailPropGroup::getLeafRange(const uint16_t leaf) const {
+    if (static_cast<size_t>(leaf) + 1 >= leafOffsets.size()) {
+      return {0, 0};
+    }
+
+    return {leafOffsets[leaf], leafOffsets[leaf + 1] - leafOffsets[leaf]};
+  }
+
+  size_t DetailPropGroup::size() const {
+    return lumpIndices.size();
+  }
+
+  DetailPropTable::DetailPropTable(const std::span<const Structs::DetailObject> detailObjects) {
+    buildGroup(models, detailObjects, true);
+    buildGroup(sprites, detailObjects, false);
+  }
+}
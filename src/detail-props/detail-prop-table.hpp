@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../structs/common.hpp"
+#include "../structs/detail-props.hpp"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Detail props of a single kind stored as a structure of arrays, sorted by leaf so each leaf owns a contiguous range.
+   */
+  struct DetailPropGroup {
+    /**
+     * Index of each detail prop in the detail object lump.
+     */
+    std::vector<uint32_t> lumpIndices;
+
+    std::vector<Structs::Vector> origins;
+    std::vector<Structs::EulerRotation> angles;
+
+    /**
+     * Index into the detail model dictionary for models, or the detail sprite dictionary for sprites.
+     */
+    std::vector<uint16_t> dictionaryIndices;
+
+    std::vector<uint16_t> leaves;
+
+    std::vector<Structs::ColourRgbExp32> lighting;
+
+    /**
+     * Index of the first entry in the detail prop light style lumps.
+     */
+    std::vector<uint32_t> firstLightStyles;
+    std::vector<uint8_t> lightStyleCounts;
+
+    std::vector<uint8_t> swayAmounts;
+    std::vector<Enums::DetailPropOrientation> orientations;
+
+    /**
+     * Only meaningful for sprites, where it distinguishes plain sprites from shaped ones.
+     */
+    std::vector<Enums::DetailPropType> types;
+
+    std::vector<uint8_t> shapeAngles;
+    std::vector<uint8_t> shapeSizes;
+    std::vector<float> scales;
+
+    /**
+     * Prefix sum of detail props per leaf, with one extra trailing entry.
+     */
+    std::vector<uint32_t> leafOffsets;
+
+    /**
+     * Returns the [first, first + count) range of detail props in the given leaf.
+     */
+    [[nodiscard]] std::pair<size_t, size_t> getLeafRange(uint16_t leaf) const;
+
+    [[nodiscard]] size_t size() const;
+  };
+
+  /**
+   * Detail props from the detail prop game lump, split by type so models and sprites can be culled and streamed per leaf
+   * without touching the lump structs.
+   */
+  struct DetailPropTable {
+    DetailPropTable() = default;
+
+    explicit DetailPropTable(std::span<const Structs::DetailObject> detailObjects);
+
+    DetailPropGroup models;
+
+    /**
+     * Sprites, including the cross and triangle shaped variants.
+     */
+    DetailPropGroup sprites;
+  };
+}
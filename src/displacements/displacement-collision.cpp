@@ -0,0 +1,92 @@
+#include "displacement-collision.hpp"
+#include "../enums/displacements.hpp"
+#include "../helpers/parallel-for.hpp"
+
+namespace BspParser {
+  using namespace Internal;
+
+  namespace {
+    DisplacementCollisionMesh generateCollisionMesh(
+      const Bsp& bsp, const uint32_t displacementIndex, const bool dropRemovedTriangles
+    ) {
+      const auto& displacement = bsp.displacements[displacementIndex];
+      const auto& dispInfo = displacement.dispInfo;
+      const auto width = displacement.numVerticesPerAxis;
+      const auto numQuads = (width - 1) * (width - 1);
+      const auto numTriangles = numQuads * 2;
+
+      if (dispInfo.dispTriStart < 0 || dispInfo.dispTriStart + numTriangles > bsp.displacementTriangles.size()) {
+        throw Errors::OutOfBoundsAccess(
+          Enums::Lump::DisplacementInfo,
+          std::format(
+            "Displacement's dispTriStart + triangle count ({} + {}) is greater than the size of the displacement "
+            "triangles lump",
+            dispInfo.dispTriStart,
+            numTriangles
+          )
+        );
+      }
+
+      const auto triangles = bsp.displacementTriangles.subspan(dispInfo.dispTriStart, numTriangles);
+
+      DisplacementCollisionMesh mesh;
+      mesh.displacementIndex = displacementIndex;
+
+      mesh.positions.reserve(displacement.vertices.size());
+      for (const auto& vertex : displacement.vertices) {
+        mesh.positions.push_back(vertex.position);
+      }
+
+      mesh.indices.reserve(numTriangles * 3);
+      mesh.triangleTags.reserve(numTriangles);
+
+      const auto emitTriangle = [&](const size_t triangleIndex, const size_t i0, const size_t i1, const size_t i2) {
+        const auto tags = triangles[triangleIndex].tags;
+        if (dropRemovedTriangles && (tags & static_cast<uint16_t>(Enums::DispTriFlag::Remove)) != 0) {
+          return;
+        }
+
+        mesh.indices.push_back(static_cast<uint16_t>(i0));
+        mesh.indices.push_back(static_cast<uint16_t>(i1));
+        mesh.indices.push_back(static_cast<uint16_t>(i2));
+        mesh.triangleTags.push_back(tags);
+      };
+
+      // Same ordering and alternating diagonals as the engine, which the triangle tags are stored in
+      for (size_t y = 0; y < width - 1; y++) {
+        for (size_t x = 0; x < width - 1; x++) {
+          const auto bottomLeft = y * width + x;
+          const auto topLeft = bottomLeft + width;
+          const auto triangleIndex = (y * (width - 1) + x) * 2;
+
+          if (bottomLeft % 2 != 0) {
+            emitTriangle(triangleIndex, bottomLeft, topLeft, bottomLeft + 1);
+            emitTriangle(triangleIndex + 1, bottomLeft + 1, topLeft, topLeft + 1);
+          } else {
+            emitTriangle(triangleIndex, bottomLeft, topLeft, topLeft + 1);
+            emitTriangle(triangleIndex + 1, bottomLeft, topLeft + 1, bottomLeft + 1);
+          }
+        }
+      }
+
+      return mesh;
+    }
+  }
+
+  std::vector<DisplacementCollisionMesh> generateDisplacementCollisionMeshes(
+    const Bsp& bsp, const bool dropRemovedTriangles
+  ) {
+    std::vector<DisplacementCollisionMesh> meshes(bsp.displacements.size());
+
+    parallelFor(
+      bsp.displacements.size(),
+      [&](const size_t displacementIndex) {
+        meshes[displacementIndex] =
+          generateCollisionMesh(bsp, static_cast<uint32_t>(displacementIndex), dropRemovedTriangles);
+      },
+      16
+    );
+
+    return meshes;
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Position-only triangle mesh of a displacement for physics.
+   */
+  struct DisplacementCollisionMesh {
+    /**
+     * Index into Bsp::displacements.
+     */
+    uint32_t displacementIndex = 0;
+
+    /**
+     * Displaced positions, indexed the same as the displacement's render vertices.
+     */
+    std::vector<Structs::Vector> positions;
+
+    /**
+     * Triangle list indices into positions, clockwise like the render triangulation.
+     */
+    std::vector<uint16_t> indices;
+
+    /**
+     * Bitwise combination of Enums::DispTriFlag values for each triangle in indices.
+     */
+    std::vector<uint16_t> triangleTags;
+  };
+
+  /**
+   * Generates collision meshes for every displacement, in parallel.
+   * Quads are split along alternating diagonals like the engine's collision, so triangles line up with their tags
+   * in Bsp::displacementTriangles. The render triangulation always uses the same diagonal, so every other quad is split
+   * differently to it.
+   * @param bsp BSP instance.
+   * @param dropRemovedTriangles Whether to leave out triangles tagged Enums::DispTriFlag::Remove.
+   * @return A mesh per displacement, indexed the same as Bsp::displacements.
+   * @throws Errors::OutOfBoundsAccess A displacement's triangles are out of bounds of the displacement triangles lump.
+   */
+  std::vector<DisplacementCollisionMesh> generateDisplacementCollisionMeshes(
+    const Bsp& bsp, bool dropRemovedTriangles = true
+  );
+}
@@ -0,0 +1,256 @@
+#include "displacement-links.hpp"
+#include "../helpers/vector-maths.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace BspParser {
+  using namespace Internal;
+
+  namespace {
+    bool listsNeighbour(const TriangulatedDisplacement& displacement, const uint32_t otherIndex) {
+      for (const auto& corner : displacement.cornerNeighbours) {
+        if (std::find(corner.begin(), corner.end(), otherIndex) != corner.end()) {
+          return true;
+        }
+      }
+
+      for (const auto& edge : displacement.edgeNeighbours) {
+        for (const auto& subNeighbour : edge.subNeighbors) {
+          if (subNeighbour.isValid() && subNeighbour.index == otherIndex) {
+            return true;
+          }
+        }
+      }
+
+      return false;
+    }
+  }
+
+  std::vector<UnlinkedDisplacementNeighbour> findUnlinkedDisplacementNeighbours(
+    const std::span<const TriangulatedDisplacement> displacements
+  ) {
+    const DisplacementCornerHash hash(displacements);
+
+    std::vector<UnlinkedDisplacementNeighbour> unlinked;
+
+    for (uint32_t displacementIndex = 0; displacementIndex < displacements.size(); displacementIndex++) {
+      const auto& displacement = displacements[displacementIndex];
+
+      // Corners touching corners are found from both displacements, but corners touching edge midpoints are only
+      // found from the displacement with the midpoint, so every pair is checked in both directions
+      const auto checkPoint = [&](const size_t vertexIndex) {
+        const auto& position = displacement.vertices[vertexIndex].position;
+
+        hash.queryCorners(position, [&](const DisplacementCornerHash::Corner& corner) {
+          const auto otherIndex = corner.displacementIndex;
+          if (otherIndex == displacementIndex) {
+            return;
+          }
+
+          const auto isLinked = listsNeighbour(displacement, otherIndex) ||
+            listsNeighbour(displacements[otherIndex], displacementIndex);
+
+          if (isLinked) {
+            return;
+          }
+
+          unlinked.push_back(
+            UnlinkedDisplacementNeighbour{
+              .displacementIndex = std::min(displacementIndex, otherIndex),
+              .otherDisplacementIndex = std::max(displacementIndex, otherIndex),
+              .position = position,
+            }
+          );
+        });
+      };
+
+      for (int32_t corner = 0; corner < 4; corner++) {
+        checkPoint(cornerToVertIdx(displacement, corner));
+      }
+
+      for (int32_t edge = 0; edge < 4; edge++) {
+        checkPoint(getEdgeMidPoint(displacement, edge));
+      }
+    }
+
+    // Pairs touching at several points are only reported once, at the first point found
+    std::stable_sort(unlinked.begin(), unlinked.end(), [](const auto& a, const auto& b) {
+      return a.displacementIndex < b.displacementIndex ||
+        (a.displacementIndex == b.displacementIndex && a.otherDisplacementIndex < b.otherDisplacementIndex);
+    });
+    unlinked.erase(
+      std::unique(
+        unlinked.begin(),
+        unlinked.end(),
+        [](const auto& a, const auto& b) {
+          return a.displacementIndex == b.displacementIndex && a.otherDisplacementIndex == b.otherDisplacementIndex;
+        }
+      ),
+      unlinked.end()
+    );
+
+    return unlinked;
+  }
+}
+
+namespace BspParser::Internal {
+  size_t cornerToVertIdx(const TriangulatedDisplacement& displacement, const int32_t corner) {
+    size_t x = 0;
+    size_t y = 0;
+
+    if (corner == TriangulatedDisplacement::CORNER_UPPER_LEFT ||
+        corner == TriangulatedDisplacement::CORNER_UPPER_RIGHT) {
+      y = displacement.numVerticesPerAxis - 1;
+    }
+
+    if (corner == TriangulatedDisplacement::CORNER_UPPER_RIGHT ||
+        corner == TriangulatedDisplacement::CORNER_LOWER_RIGHT) {
+      x = displacement.numVerticesPerAxis - 1;
+    }
+
+    return y * displacement.numVerticesPerAxis + x;
+  }
+
+  size_t getEdgeMidPoint(const TriangulatedDisplacement& displacement, const int32_t edge) {
+    const auto end = displacement.numVerticesPerAxis - 1;
+    const auto mid = displacement.numVerticesPerAxis / 2;
+
+    size_t x = 0;
+    size_t y = 0;
+
+    switch (edge) {
+      case TriangulatedDisplacement::EDGE_LEFT:
+        y = mid;
+        break;
+      case TriangulatedDisplacement::EDGE_TOP:
+        x = mid;
+        y = end;
+        break;
+      case TriangulatedDisplacement::EDGE_RIGHT:
+        x = end;
+        y = mid;
+        break;
+      case TriangulatedDisplacement::EDGE_BOTTOM:
+        x = mid;
+        break;
+      default:
+        break;
+    }
+
+    return y * displacement.numVerticesPerAxis + x;
+  }
+
+  DisplacementCornerHash::DisplacementCornerHash(const std::span<const TriangulatedDisplacement> displacements) {
+    corners.reserve(displacements.size() * 4);
+
+    for (uint32_t displacementIndex = 0; displacementIndex < displacements.size(); displacementIndex++) {
+      addCorners(displacementIndex, displacements[displacementIndex]);
+    }
+
+    buildCells();
+  }
+
+  void DisplacementCornerHash::addCorners(
+    const uint32_t displacementIndex, const TriangulatedDisplacement& displacement
+  ) {
+    for (int32_t corner = 0; corner < 4; corner++) {
+      corners.push_back(
+        Corner{
+          .displacementIndex = displacementIndex,
+          .corner = corner,
+          .position = displacement.vertices[cornerToVertIdx(displacement, corner)].position,
+        }
+      );
+    }
+  }
+
+  void DisplacementCornerHash::buildCells() {
+    // Each corner goes in every cell its tolerance overlaps, which is at most two per axis
+    const auto forEachOverlappedCell = [](const Corner& corner, const auto& function) {
+      const auto first = getCellCoordinate(sub(corner.position, Structs::Vector{TOLERANCE, TOLERANCE, TOLERANCE}));
+      const auto last = getCellCoordinate(add(corner.position, Structs::Vector{TOLERANCE, TOLERANCE, TOLERANCE}));
+
+      for (auto z = first[2]; z <= last[2]; z++) {
+        for (auto y = first[1]; y <= last[1]; y++) {
+          for (auto x = first[0]; x <= last[0]; x++) {
+            function(getCellKey({x, y, z}));
+          }
+        }
+      }
+    };
+
+    size_t numEntries = 0;
+    for (const auto& corner : corners) {
+      forEachOverlappedCell(corner, [&numEntries](uint64_t) { numEntries++; });
+    }
+
+    // There are never more occupied cells than entries, so the table stays at most two thirds full
+    cells.resize(std::bit_ceil(std::max(numEntries + numEntries / 2, static_cast<size_t>(16))));
+    cellCorners.resize(numEntries);
+
+    // Count the corners in each cell, then turn the counts into ranges and fill them
+    for (const auto& corner : corners) {
+      forEachOverlappedCell(corner, [this](const uint64_t key) {
+        auto& cell = cells[getSlot(key)];
+        cell.key = key;
+        cell.endCorner++;
+      });
+    }
+
+    uint32_t offset = 0;
+    for (auto& cell : cells) {
+      const auto count = cell.endCorner;
+      cell.firstCorner = cell.endCorner = offset;
+      offset += count;
+    }
+
+    for (uint32_t cornerIndex = 0; cornerIndex < corners.size(); cornerIndex++) {
+      forEachOverlappedCell(corners[cornerIndex], [this, cornerIndex](const uint64_t key) {
+        cellCorners[cells[getSlot(key)].endCorner++] = cornerIndex;
+      });
+    }
+  }
+
+  std::array<int32_t, 3> DisplacementCornerHash::getCellCoordinate(const Structs::Vector& position) {
+    // std::floor is a library call without SSE4.1, so truncate and step down for negative fractions instead
+    const auto toCell = [](const float value) {
+      const auto scaled = value * (1.f / CELL_SIZE) + 0.5f;
+      const auto truncated = static_cast<int32_t>(scaled);
+
+      return truncated - static_cast<int32_t>(scaled < static_cast<float>(truncated));
+    };
+
+    return {toCell(position.x), toCell(position.y), toCell(position.z)};
+  }
+
+  uint64_t DisplacementCornerHash::getCellKey(const std::array<int32_t, 3>& coordinate) {
+    // 21 bits per axis wraps every 2^21 cells (over 500,000 units), far beyond the size of any map
+    constexpr uint64_t mask = (1ull << 21) - 1;
+
+    return (static_cast<uint64_t>(coordinate[0]) & mask) | ((static_cast<uint64_t>(coordinate[1]) & mask) << 21) |
+      ((static_cast<uint64_t>(coordinate[2]) & mask) << 42);
+  }
+
+  size_t DisplacementCornerHash::getSlot(const uint64_t key) const {
+    // Fibonacci hashing spreads neighbouring cells across the table
+    const auto mask = cells.size() - 1;
+    auto slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+    while (cells[slot].key != EMPTY_KEY && cells[slot].key != key) {
+      slot = (slot + 1) & mask;
+    }
+
+    return slot;
+  }
+
+  const DisplacementCornerHash::Cell* DisplacementCornerHash::findCell(const uint64_t key) const {
+    if (cells.empty()) {
+      return nullptr;
+    }
+
+    const auto& cell = cells[getSlot(key)];
+
+    return cell.key == key ? &cell : nullptr;
+  }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "triangulated-displacement.hpp"
+#include "../helpers/vector-maths.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <limits>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Pair of displacements where a corner of one touches a corner or edge midpoint of the other, without either listing
+   * the other as a neighbour.
+   */
+  struct UnlinkedDisplacementNeighbour {
+    /**
+     * Index into the displacements, always less than otherDisplacementIndex.
+     */
+    uint32_t displacementIndex = 0;
+    uint32_t otherDisplacementIndex = 0;
+
+    /**
+     * Position of the first touching point found.
+     */
+    Structs::Vector position;
+  };
+
+  /**
+   * Finds displacements which touch but weren't linked as neighbours when the map was compiled.
+   * Normals aren't blended across these, so they show up as lighting seams.
+   * @param displacements All displacements in the BSP, such as Bsp::displacements.
+   * @return Each unlinked pair once, sorted by displacement index.
+   */
+  std::vector<UnlinkedDisplacementNeighbour> findUnlinkedDisplacementNeighbours(
+    std::span<const TriangulatedDisplacement> displacements
+  );
+}
+
+namespace BspParser::Internal {
+  /**
+   * Vertex index of a corner of a displacement, from TriangulatedDisplacement::CORNER_*.
+   */
+  size_t cornerToVertIdx(const TriangulatedDisplacement& displacement, int32_t corner);
+
+  /**
+   * Vertex index of the middle of an edge of a displacement, from TriangulatedDisplacement::EDGE_*.
+   */
+  size_t getEdgeMidPoint(const TriangulatedDisplacement& displacement, int32_t edge);
+
+  /**
+   * Corner positions of every displacement, hashed by position so the corners touching a point are found with a single
+   * lookup rather than by comparing against every corner of every displacement.
+   * @note Positions are read once on construction, so the hash must be rebuilt if any displacement moves.
+   */
+  class DisplacementCornerHash {
+  public:
+    /**
+     * Distance within which points are treated as the same, matching VRAD.
+     */
+    static constexpr float TOLERANCE = 0.1f;
+
+    struct Corner {
+      uint32_t displacementIndex;
+      int32_t corner;
+      Structs::Vector position;
+    };
+
+    explicit DisplacementCornerHash(std::span<const TriangulatedDisplacement> displacements);
+
+    /**
+     * Calls callback with each corner within TOLERANCE of a position.
+     */
+    template <typename Callback>
+    void queryCorners(const Structs::Vector& position, Callback&& callback) const {
+      const auto* cell = findCell(getCellKey(getCellCoordinate(position)));
+      if (cell == nullptr) {
+        return;
+      }
+
+      for (auto cornerIndex = cell->firstCorner; cornerIndex < cell->endCorner; cornerIndex++) {
+        const auto& corner = corners[cellCorners[cornerIndex]];
+
+        // Measured the same way as displacement normal blending, so both agree on which points touch
+        if (length(sub(corner.position, position)) <= TOLERANCE) {
+          callback(corner);
+        }
+      }
+    }
+
+  private:
+    /**
+     * Cells are larger than the tolerance so each corner is only stored in the few cells its tolerance overlaps,
+     * and every corner near a position is in the position's own cell. Cells are centred on multiples of their size,
+     * so corners on the integer grid most maps are built on only occupy one.
+     */
+    static constexpr float CELL_SIZE = TOLERANCE * 2.5f;
+
+    static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * Slot of the open addressed cell table, holding a range of cellCorners.
+     */
+    struct Cell {
+      uint64_t key = EMPTY_KEY;
+      uint32_t firstCorner = 0;
+      uint32_t endCorner = 0;
+    };
+
+    std::vector<Corner> corners;
+
+    /**
+     * Occupied cells, linearly probed. The size is a power of two at least twice the number of occupied cells.
+     */
+    std::vector<Cell> cells;
+    std::vector<uint32_t> cellCorners;
+
+    void addCorners(uint32_t displacementIndex, const TriangulatedDisplacement& displacement);
+    void buildCells();
+
+    [[nodiscard]] static std::array<int32_t, 3> getCellCoordinate(const Structs::Vector& position);
+    [[nodiscard]] static uint64_t getCellKey(const std::array<int32_t, 3>& coordinate);
+
+    [[nodiscard]] size_t getSlot(uint64_t key) const;
+    [[nodiscard]] const Cell* findCell(uint64_t key) const;
+  };
+}
@@ -0,0 +1,103 @@
+#include "triangulated-displacement.hpp"
+#include <array>
+#include <format>
+#include <stdexcept>
+
+namespace BspParser {
+  uint8_t TriangulatedDisplacement::getMaxLod() const {
+    // Newer engine branches store flags in the high bits of minTess, so only treat small values as a tessellation
+    const auto minPower = dispInfo.minTess >= 0 && dispInfo.minTess <= dispInfo.power ? dispInfo.minTess : 0;
+
+    return static_cast<uint8_t>(dispInfo.power - minPower);
+  }
+
+  bool TriangulatedDisplacement::isVertexAllowed(const size_t x, const size_t y) const {
+    const auto index = getVertexIndex(x, y);
+
+    return (dispInfo.allowedVertices[index / 32] & (1u << (index % 32))) != 0;
+  }
+
+  size_t TriangulatedDisplacement::getLodTriangleListIndexCount(const uint8_t lod) const {
+    size_t numIndices = 0;
+    generateLodTriangleListIndices(lod, [&numIndices](uint32_t, uint32_t, uint32_t) { numIndices += 3; });
+
+    return numIndices;
+  }
+
+  void TriangulatedDisplacement::generateLodTriangleListIndices(
+    const uint8_t lod, const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
+  ) const {
+    if (lod > getMaxLod()) {
+      throw std::invalid_argument(
+        std::format("Displacement level of detail {} exceeds the maximum of {}", lod, getMaxLod())
+      );
+    }
+
+    if (lod == 0) {
+      generateTriangleListIndices(iteratee);
+      return;
+    }
+
+    const auto last = numVerticesPerAxis - 1;
+    const auto stride = static_cast<size_t>(1) << lod;
+    const auto halfStride = stride / 2;
+
+    // Vertices on the displacement's edges are shared with neighbours, so only use those the neighbours have too
+    const auto isUsable = [&](const size_t x, const size_t y) {
+      const auto onEdge = x == 0 || y == 0 || x == last || y == last;
+      return !onEdge || isVertexAllowed(x, y);
+    };
+
+    // Corners in clockwise order, matching the winding of the full detail triangles
+    constexpr std::array<std::array<size_t, 2>, 4> cellCorners{{{0, 0}, {0, 1}, {1, 1}, {1, 0}}};
+
+    std::vector<uint32_t> outline;
+    outline.reserve(stride * 4);
+
+    for (size_t cellY = 0; cellY < last; cellY += stride) {
+      for (size_t cellX = 0; cellX < last; cellX += stride) {
+        const auto bottomLeft = static_cast<uint32_t>(getVertexIndex(cellX, cellY));
+        const auto topLeft = static_cast<uint32_t>(getVertexIndex(cellX, cellY + stride));
+        const auto topRight = static_cast<uint32_t>(getVertexIndex(cellX + stride, cellY + stride));
+        const auto bottomRight = static_cast<uint32_t>(getVertexIndex(cellX + stride, cellY));
+
+        const auto touchesEdge = cellX == 0 || cellY == 0 || cellX + stride == last || cellY + stride == last;
+        if (!touchesEdge) {
+          iteratee(bottomLeft, topLeft, topRight);
+          iteratee(bottomLeft, topRight, bottomRight);
+          continue;
+        }
+
+        // Walk the cell's outline, taking every usable vertex along sides on the displacement's edge,
+        // then fan it from the cell's centre vertex so vertices in a line never form a degenerate triangle
+        outline.clear();
+        for (size_t side = 0; side < 4; side++) {
+          const auto startX = cellX + cellCorners[side][0] * stride;
+          const auto startY = cellY + cellCorners[side][1] * stride;
+          const auto endX = cellX + cellCorners[(side + 1) % 4][0] * stride;
+          const auto endY = cellY + cellCorners[(side + 1) % 4][1] * stride;
+
+          const auto onEdge = (startX == endX && (startX == 0 || startX == last)) ||
+            (startY == endY && (startY == 0 || startY == last));
+          const auto step = onEdge ? 1 : stride;
+          const auto stepX = endX > startX ? 1 : endX < startX ? -1 : 0;
+          const auto stepY = endY > startY ? 1 : endY < startY ? -1 : 0;
+
+          for (size_t i = 0; i < stride; i += step) {
+            const auto x = static_cast<size_t>(static_cast<ptrdiff_t>(startX) + stepX * static_cast<ptrdiff_t>(i));
+            const auto y = static_cast<size_t>(static_cast<ptrdiff_t>(startY) + stepY * static_cast<ptrdiff_t>(i));
+
+            if (isUsable(x, y)) {
+              outline.push_back(static_cast<uint32_t>(getVertexIndex(x, y)));
+            }
+          }
+        }
+
+        const auto centre = static_cast<uint32_t>(getVertexIndex(cellX + halfStride, cellY + halfStride));
+        for (size_t i = 0; i < outline.size(); i++) {
+          iteratee(centre, outline[i], outline[(i + 1) % outline.size()]);
+        }
+      }
+    }
+  }
+}
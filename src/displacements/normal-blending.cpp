@@ -1,6 +1,10 @@
 #include "normal-blending.hpp"
+#include "displacement-links.hpp"
 #include "sub-edge-iterator.hpp"
 #include "../helpers/vector-maths.hpp"
+#include <algorithm>
+#include <format>
+#include <stdexcept>
 
 namespace BspParser::Internal {
   namespace {
@@ -30,50 +34,45 @@ namespace BspParser::Internal {
       return std::move(neighbourIndices);
     }
 
-    size_t cornerToVertIdx(const TriangulatedDisplacement& displacement, const int32_t corner) {
-      size_t x = 0;
-      size_t y = 0;
+    /**
+     * State shared by every blend in a pass. Frozen displacements are already blended, so they're read but never
+     * written, and their normals win wherever they meet a displacement being blended.
+     */
+    struct BlendContext {
+      std::span<TriangulatedDisplacement> displacements;
 
-      if (corner == TriangulatedDisplacement::CORNER_UPPER_LEFT ||
-          corner == TriangulatedDisplacement::CORNER_UPPER_RIGHT) {
-        y = displacement.numVerticesPerAxis - 1;
-      }
+      /**
+       * Flag per displacement, or empty if none are frozen.
+       */
+      std::span<const uint8_t> frozen = {};
 
-      if (corner == TriangulatedDisplacement::CORNER_UPPER_RIGHT ||
-          corner == TriangulatedDisplacement::CORNER_LOWER_RIGHT) {
-        x = displacement.numVerticesPerAxis - 1;
+      [[nodiscard]] bool isFrozen(const size_t displacementIndex) const {
+        return !frozen.empty() && frozen[displacementIndex] != 0;
       }
+    };
 
-      return y * displacement.numVerticesPerAxis + x;
-    }
+    /**
+     * Resets a displacement's normals to how they were before blending, first saving them if it hasn't been blended.
+     */
+    void resetToUnblended(TriangulatedDisplacement& displacement) {
+      auto& vertices = displacement.vertices;
 
-    size_t getEdgeMidPoint(const TriangulatedDisplacement& displacement, const int32_t edge) {
-      const auto end = displacement.numVerticesPerAxis - 1;
-      const auto mid = displacement.numVerticesPerAxis / 2;
-
-      size_t x = 0;
-      size_t y = 0;
-
-      switch (edge) {
-        case TriangulatedDisplacement::EDGE_LEFT:
-          y = mid;
-          break;
-        case TriangulatedDisplacement::EDGE_TOP:
-          x = mid;
-          y = end;
-          break;
-        case TriangulatedDisplacement::EDGE_RIGHT:
-          x = end;
-          y = mid;
-          break;
-        case TriangulatedDisplacement::EDGE_BOTTOM:
-          x = mid;
-          break;
-        default:
-          break;
+      if (displacement.unblendedNormals.size() != vertices.size()) {
+        displacement.unblendedNormals.resize(vertices.size());
+        displacement.unblendedTangents.resize(vertices.size());
+
+        for (size_t i = 0; i < vertices.size(); i++) {
+          displacement.unblendedNormals[i] = vertices[i].normal;
+          displacement.unblendedTangents[i] = vertices[i].tangent;
+        }
+
+        return;
       }
 
-      return y * displacement.numVerticesPerAxis + x;
+      for (size_t i = 0; i < vertices.size(); i++) {
+        vertices[i].normal = displacement.unblendedNormals[i];
+        vertices[i].tangent = displacement.unblendedTangents[i];
+      }
     }
 
     int32_t findNeighbourCorner(const TriangulatedDisplacement& displacement, const Structs::Vector& test) {
@@ -94,10 +93,32 @@ namespace BspParser::Internal {
         }
       }
 
-      return closestDistance <= 0.1f ? closestCorner : -1;
+      return closestDistance <= DisplacementCornerHash::TOLERANCE ? closestCorner : -1;
+    }
+
+    /**
+     * Midpoint of an edge split between two sub-neighbours, where their corners form a T-junction.
+     * @return The midpoint vertex, or nullptr if none of the displacement's T-junctions touch the position.
+     */
+    const Vertex* findTJunctionMidPoint(const TriangulatedDisplacement& displacement, const Structs::Vector& test) {
+      for (int32_t edgeIndex = 0; edgeIndex < 4; edgeIndex++) {
+        const auto& subNeighbours = displacement.edgeNeighbours.at(edgeIndex).subNeighbors;
+        if (!subNeighbours[0].isValid() || !subNeighbours[1].isValid()) {
+          continue;
+        }
+
+        const auto& midPoint = displacement.vertices[getEdgeMidPoint(displacement, edgeIndex)];
+        if (length(sub(midPoint.position, test)) <= DisplacementCornerHash::TOLERANCE) {
+          return &midPoint;
+        }
+      }
+
+      return nullptr;
     }
 
-    void blendCorners(const std::span<TriangulatedDisplacement> displacements, TriangulatedDisplacement& displacement) {
+    void blendCorners(const BlendContext& context, TriangulatedDisplacement& displacement) {
+      const auto displacements = context.displacements;
+
       const auto neighbourIndices = getAllNeighbourIndices(displacement);
       std::vector neighbourCornerVertexIndices(neighbourIndices.size(), -1);
 
@@ -108,6 +129,7 @@ namespace BspParser::Internal {
         auto divisor = 1.f;
         auto averageT = xyz(cornerVertex.tangent);
         auto averageN = cornerVertex.normal;
+        const Vertex* frozenVertex = nullptr;
 
         for (size_t neighbourIndex = 0; neighbourIndex < neighbourIndices.size(); neighbourIndex++) {
           const auto& neighbour = displacements[neighbourIndices[neighbourIndex]];
@@ -115,6 +137,14 @@ namespace BspParser::Internal {
 
           if (neighbourCorner < 0) {
             neighbourCornerVertexIndices[neighbourIndex] = -1;
+
+            // A frozen displacement's T-junctions aren't blended again, so its midpoint wins like a frozen corner
+            if (context.isFrozen(neighbourIndices[neighbourIndex])) {
+              if (const auto* midPoint = findTJunctionMidPoint(neighbour, cornerVertex.position)) {
+                frozenVertex = midPoint;
+              }
+            }
+
             continue;
           }
 
@@ -122,20 +152,29 @@ namespace BspParser::Internal {
           const auto& neighbourVertex = neighbour.vertices[neighbourCornerVertexIndex];
           neighbourCornerVertexIndices[neighbourIndex] = neighbourCornerVertexIndex;
 
+          if (context.isFrozen(neighbourIndices[neighbourIndex])) {
+            frozenVertex = &neighbourVertex;
+          }
+
           averageT = add(averageT, xyz(neighbourVertex.tangent));
           averageN = add(averageN, neighbourVertex.normal);
           divisor++;
         }
 
-        averageT = div(averageT, divisor);
-        averageN = div(averageN, divisor);
+        if (frozenVertex != nullptr) {
+          averageT = xyz(frozenVertex->tangent);
+          averageN = frozenVertex->normal;
+        } else {
+          averageT = div(averageT, divisor);
+          averageN = div(averageN, divisor);
+        }
 
         cornerVertex.tangent = Structs::Vector4{averageT.x, averageT.y, averageT.z, cornerVertex.tangent.w};
         cornerVertex.normal = averageN;
 
         for (size_t neighbourIndex = 0; neighbourIndex < neighbourIndices.size(); neighbourIndex++) {
           const auto vertexIndex = neighbourCornerVertexIndices[neighbourIndex];
-          if (vertexIndex < 0) {
+          if (vertexIndex < 0 || context.isFrozen(neighbourIndices[neighbourIndex])) {
             continue;
           }
 
@@ -147,7 +186,7 @@ namespace BspParser::Internal {
     }
 
     void blendTJunctions(
-      const std::span<TriangulatedDisplacement> displacements,
+      const BlendContext& context,
       TriangulatedDisplacement& displacement,
       const Structs::DispNeighbour& neighbour,
       const int32_t edgeIndex
@@ -159,8 +198,10 @@ namespace BspParser::Internal {
       const auto midPointVertexIndex = getEdgeMidPoint(displacement, edgeIndex);
       auto& midPoint = displacement.vertices[midPointVertexIndex];
 
-      auto& neighbourA = displacements[neighbour.subNeighbors[0].index];
-      auto& neighbourB = displacements[neighbour.subNeighbors[1].index];
+      const auto neighbourAIndex = neighbour.subNeighbors[0].index;
+      const auto neighbourBIndex = neighbour.subNeighbors[1].index;
+      auto& neighbourA = context.displacements[neighbourAIndex];
+      auto& neighbourB = context.displacements[neighbourBIndex];
 
       const auto cornerA = findNeighbourCorner(neighbourA, midPoint.position);
       const auto cornerB = findNeighbourCorner(neighbourB, midPoint.position);
@@ -172,6 +213,27 @@ namespace BspParser::Internal {
       auto& cornerAVertex = neighbourA.vertices[cornerToVertIdx(neighbourA, cornerA)];
       auto& cornerBVertex = neighbourB.vertices[cornerToVertIdx(neighbourB, cornerB)];
 
+      const auto isAFrozen = context.isFrozen(neighbourAIndex);
+      const auto isBFrozen = context.isFrozen(neighbourBIndex);
+
+      if (isAFrozen || isBFrozen) {
+        const auto& frozenVertex = isAFrozen ? cornerAVertex : cornerBVertex;
+        const auto tangent = Structs::Vector4{
+          frozenVertex.tangent.x, frozenVertex.tangent.y, frozenVertex.tangent.z, midPoint.tangent.w
+        };
+
+        midPoint.tangent = tangent;
+        midPoint.normal = frozenVertex.normal;
+
+        auto& otherVertex = isAFrozen ? cornerBVertex : cornerAVertex;
+        if (!isAFrozen || !isBFrozen) {
+          otherVertex.tangent = tangent;
+          otherVertex.normal = frozenVertex.normal;
+        }
+
+        return;
+      }
+
       const auto averageT = div(add(xyz(midPoint.tangent), xyz(cornerAVertex.tangent), xyz(cornerBVertex.tangent)), 3);
       const auto averageN = div(add(midPoint.normal, cornerAVertex.normal, cornerBVertex.normal), 3);
 
@@ -181,7 +243,7 @@ namespace BspParser::Internal {
     }
 
     void blendEdges(
-      const std::span<TriangulatedDisplacement> displacements,
+      const BlendContext& context,
       TriangulatedDisplacement& displacement,
       const Structs::DispNeighbour& neighbour,
       const int32_t edgeIndex
@@ -192,7 +254,8 @@ namespace BspParser::Internal {
           continue;
         }
 
-        auto& neighbourDisplacement = displacements[subNeighbour.index];
+        auto& neighbourDisplacement = context.displacements[subNeighbour.index];
+        const auto isNeighbourFrozen = context.isFrozen(subNeighbour.index);
 
         SubEdgeIterator iterator(displacement, subNeighbour, neighbourDisplacement, edgeIndex, subNeighbourIndex, true);
         const auto freeAxis = iterator.getFreeAxis();
@@ -207,14 +270,22 @@ namespace BspParser::Internal {
             auto& vertex = displacement.vertices[iterator.getVertexIndex()];
             auto& neighbourVertex = neighbourDisplacement.vertices[iterator.getNeighbourVertexIndex()];
 
-            // TODO #174: Do we need to handle different handedness?
-            const auto averageT = div(add(xyz(vertex.tangent), xyz(neighbourVertex.tangent)), 2);
-            const auto averageN = div(add(vertex.normal, neighbourVertex.normal), 2);
-
-            vertex.tangent = Structs::Vector4{averageT.x, averageT.y, averageT.z, vertex.tangent.w};
-            vertex.normal = averageN;
-            neighbourVertex.tangent = Structs::Vector4{averageT.x, averageT.y, averageT.z, neighbourVertex.tangent.w};
-            neighbourVertex.normal = averageN;
+            if (isNeighbourFrozen) {
+              vertex.tangent = Structs::Vector4{
+                neighbourVertex.tangent.x, neighbourVertex.tangent.y, neighbourVertex.tangent.z, vertex.tangent.w
+              };
+              vertex.normal = neighbourVertex.normal;
+            } else {
+              // TODO #174: Do we need to handle different handedness?
+              const auto averageT = div(add(xyz(vertex.tangent), xyz(neighbourVertex.tangent)), 2);
+              const auto averageN = div(add(vertex.normal, neighbourVertex.normal), 2);
+
+              vertex.tangent = Structs::Vector4{averageT.x, averageT.y, averageT.z, vertex.tangent.w};
+              vertex.normal = averageN;
+              neighbourVertex.tangent =
+                Structs::Vector4{averageT.x, averageT.y, averageT.z, neighbourVertex.tangent.w};
+              neighbourVertex.normal = averageN;
+            }
           }
 
           const auto previousPosFreeAxis = previousPos[freeAxis];
@@ -248,18 +319,70 @@ namespace BspParser::Internal {
         }
       }
     }
+
+    void blendDisplacement(const BlendContext& context, TriangulatedDisplacement& displacement) {
+      blendCorners(context, displacement);
+
+      for (int edgeIndex = 0; edgeIndex < 4; edgeIndex++) {
+        const auto& edgeNeighbour = displacement.edgeNeighbours.at(edgeIndex);
+
+        blendTJunctions(context, displacement, edgeNeighbour, edgeIndex);
+        blendEdges(context, displacement, edgeNeighbour, edgeIndex);
+      }
+    }
   }
 
   void blendNeighbouringDisplacementNormals(const std::span<TriangulatedDisplacement> displacements) {
     for (auto& displacement : displacements) {
-      blendCorners(displacements, displacement);
+      resetToUnblended(displacement);
+    }
 
-      for (int edgeIndex = 0; edgeIndex < 4; edgeIndex++) {
-        const auto& edgeNeighbour = displacement.edgeNeighbours.at(edgeIndex);
+    const BlendContext context{.displacements = displacements};
 
-        blendTJunctions(displacements, displacement, edgeNeighbour, edgeIndex);
-        blendEdges(displacements, displacement, edgeNeighbour, edgeIndex);
+    for (auto& displacement : displacements) {
+      blendDisplacement(context, displacement);
+    }
+  }
+
+  void reblendDisplacementNormals(
+    const std::span<TriangulatedDisplacement> displacements, const std::span<const uint32_t> changedDisplacements
+  ) {
+    // Changed displacements and their neighbours are re-blended, and anything further out is frozen
+    std::vector<uint8_t> frozen(displacements.size(), 1);
+    std::vector<uint32_t> reblended;
+
+    const auto addReblended = [&](const size_t displacementIndex) {
+      if (displacementIndex >= displacements.size()) {
+        throw std::out_of_range(
+          std::format("Displacement '{}' is out of bounds of the displacements", displacementIndex)
+        );
+      }
+
+      if (frozen[displacementIndex] != 0) {
+        frozen[displacementIndex] = 0;
+        reblended.push_back(static_cast<uint32_t>(displacementIndex));
+      }
+    };
+
+    for (const auto displacementIndex : changedDisplacements) {
+      addReblended(displacementIndex);
+
+      for (const auto neighbourIndex : getAllNeighbourIndices(displacements[displacementIndex])) {
+        addReblended(neighbourIndex);
       }
     }
+
+    // Blends are applied in index order like a full pass
+    std::sort(reblended.begin(), reblended.end());
+
+    for (const auto displacementIndex : reblended) {
+      resetToUnblended(displacements[displacementIndex]);
+    }
+
+    const BlendContext context{.displacements = displacements, .frozen = frozen};
+
+    for (const auto displacementIndex : reblended) {
+      blendDisplacement(context, displacements[displacementIndex]);
+    }
   }
 }
@@ -1,11 +1,28 @@
 #pragma once
 
 #include "triangulated-displacement.hpp"
+#include <cstdint>
+#include <span>
 
 namespace BspParser::Internal {
   /**
+   * Normals are first reset to how they were before any blending, so blending again gives the same result.
    * @remarks Largely copied from VRAD in the Source Engine 2013 SDK, with some cleanup.
    * @param displacements All displacements in the BSP. Indices must match the underlying displacement infos.
    */
   void blendNeighbouringDisplacementNormals(std::span<TriangulatedDisplacement> displacements);
+
+  /**
+   * Re-blends changed displacements and the neighbours they list, leaving every other displacement untouched.
+   * Where a re-blended displacement meets an untouched one it takes the untouched side's normals, which already
+   * account for everything around them, so blending the same changes again gives the same result.
+   * @note Matches a full blend, except for edge vertices next to a T-junction on a sub-neighbour with more vertices
+   * along the edge. A full blend can interpolate those before the T-junction is averaged, while this always
+   * interpolates from the averaged T-junction.
+   * @param displacements All displacements in the BSP, previously blended with blendNeighbouringDisplacementNormals.
+   * @param changedDisplacements Indices into displacements of the displacements which changed.
+   */
+  void reblendDisplacementNormals(
+    std::span<TriangulatedDisplacement> displacements, std::span<const uint32_t> changedDisplacements
+  );
 }
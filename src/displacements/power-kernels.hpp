@@ -0,0 +1,195 @@
+#pragma once
+
+#include "../helpers/calculate-tangent.hpp"
+#include "../limits.hpp"
+#include "../vertex.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace BspParser::Internal {
+  /**
+   * Compile time dimensions of a displacement's vertex grid.
+   */
+  template <size_t Power>
+  struct DisplacementGrid {
+    static_assert(Power >= Limits::MIN_MAP_DISP_POWER && Power <= Limits::MAX_MAP_DISP_POWER);
+
+    static constexpr size_t VERTICES_PER_AXIS = (static_cast<size_t>(1) << Power) + 1;
+    static constexpr size_t VERTEX_COUNT = VERTICES_PER_AXIS * VERTICES_PER_AXIS;
+
+    static constexpr size_t getVertexIndex(const size_t x, const size_t y) {
+      return y * VERTICES_PER_AXIS + x;
+    }
+  };
+
+  /**
+   * Calls function once with std::integral_constant<size_t, power>, so it can be instantiated per legal power.
+   * @return false without calling function if the power is outside the legal range.
+   */
+  template <typename Function>
+  bool dispatchDisplacementPower(const int32_t power, const Function& function) {
+    static_assert(Limits::MIN_MAP_DISP_POWER == 2 && Limits::MAX_MAP_DISP_POWER == 4);
+
+    switch (power) {
+      case 2:
+        function(std::integral_constant<size_t, 2>{});
+        return true;
+      case 3:
+        function(std::integral_constant<size_t, 3>{});
+        return true;
+      case 4:
+        function(std::integral_constant<size_t, 4>{});
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /**
+   * Number of floats in each plane of GridNormalScratch for a grid of the given width.
+   */
+  constexpr size_t getGridNormalPlaneSize(const size_t verticesPerAxis) {
+    return verticesPerAxis * verticesPerAxis + verticesPerAxis + 1;
+  }
+
+  /**
+   * Scratch space for generateGridNormals, split into separate x, y and z planes so every pass runs over contiguous
+   * floats. Keeping the planes as distinct members lets the compiler see they never overlap.
+   * @tparam Plane Float container of at least getGridNormalPlaneSize(verticesPerAxis) elements.
+   */
+  template <typename Plane>
+  struct GridNormalScratch {
+    // Positions, which are overwritten by the summed normals once the quads are built
+    Plane x;
+    Plane y;
+    Plane z;
+    Plane quadX;
+    Plane quadY;
+    Plane quadZ;
+  };
+
+  /**
+   * Generates smooth normals for a grid of vertices. The cross product of a quad's diagonals equals the sum of its two
+   * triangles' cross products, so each quad is computed once and shared by its four corners rather than being
+   * recomputed for every vertex touching it. Quads are taken whole to avoid seams along triangulated edges.
+   * @param verticesPerAxis Width and height of the grid.
+   * @param vertices Grid vertices with positions filled in, row by row.
+   * @param scratch Scratch planes, see GridNormalScratch.
+   * @param normals Receives a unit normal per vertex.
+   */
+  template <typename Plane>
+  void generateGridNormals(
+    const size_t verticesPerAxis,
+    const std::span<const Vertex> vertices,
+    GridNormalScratch<Plane>& scratch,
+    const std::span<Structs::Vector> normals
+  ) {
+    const auto vertexCount = verticesPerAxis * verticesPerAxis;
+
+    for (size_t i = 0; i < vertexCount; i++) {
+      scratch.x[i] = vertices[i].position.x;
+      scratch.y[i] = vertices[i].position.y;
+      scratch.z[i] = vertices[i].position.z;
+    }
+
+    // The quad with bottom left vertex i is stored at i + verticesPerAxis + 1, which leaves a border of zeroes in the
+    // first row and column so every vertex sums the same four quads without branching. A vertex on the right edge
+    // would start a quad wrapping onto the next row; those land in the border column and are cleared afterwards.
+    // Every pass is a single loop over the whole grid, rather than short loops per row.
+    const auto quadOffset = verticesPerAxis + 1;
+
+    for (size_t i = 0; i + quadOffset < vertexCount; i++) {
+      // Clockwise, matching the winding of the triangle list
+      const auto ax = scratch.x[i + quadOffset] - scratch.x[i];
+      const auto ay = scratch.y[i + quadOffset] - scratch.y[i];
+      const auto az = scratch.z[i + quadOffset] - scratch.z[i];
+      const auto bx = scratch.x[i + verticesPerAxis] - scratch.x[i + 1];
+      const auto by = scratch.y[i + verticesPerAxis] - scratch.y[i + 1];
+      const auto bz = scratch.z[i + verticesPerAxis] - scratch.z[i + 1];
+
+      scratch.quadX[i + quadOffset] = ay * bz - az * by;
+      scratch.quadY[i + quadOffset] = az * bx - ax * bz;
+      scratch.quadZ[i + quadOffset] = ax * by - ay * bx;
+    }
+
+    for (size_t i = 0; i < quadOffset; i++) {
+      scratch.quadX[i] = scratch.quadY[i] = scratch.quadZ[i] = 0;
+      scratch.quadX[vertexCount + i] = scratch.quadY[vertexCount + i] = scratch.quadZ[vertexCount + i] = 0;
+    }
+
+    for (size_t i = verticesPerAxis; i < vertexCount; i += verticesPerAxis) {
+      scratch.quadX[i] = scratch.quadY[i] = scratch.quadZ[i] = 0;
+    }
+
+    for (size_t i = 0; i < vertexCount; i++) {
+      const auto top = i + verticesPerAxis;
+
+      scratch.x[i] = scratch.quadX[i] + scratch.quadX[i + 1] + scratch.quadX[top] + scratch.quadX[top + 1];
+      scratch.y[i] = scratch.quadY[i] + scratch.quadY[i + 1] + scratch.quadY[top] + scratch.quadY[top + 1];
+      scratch.z[i] = scratch.quadZ[i] + scratch.quadZ[i + 1] + scratch.quadZ[top] + scratch.quadZ[top + 1];
+    }
+
+    // Only free of branches when sqrt doesn't have to set errno, see -fno-math-errno in CMakeLists.txt
+    for (size_t i = 0; i < vertexCount; i++) {
+      const auto x = scratch.x[i];
+      const auto y = scratch.y[i];
+      const auto z = scratch.z[i];
+      const auto inverseLength = 1.f / std::sqrt(x * x + y * y + z * z);
+
+      scratch.x[i] = x * inverseLength;
+      scratch.y[i] = y * inverseLength;
+      scratch.z[i] = z * inverseLength;
+    }
+
+    for (size_t i = 0; i < vertexCount; i++) {
+      normals[i] = Structs::Vector{scratch.x[i], scratch.y[i], scratch.z[i]};
+    }
+  }
+
+  /**
+   * Generates normals and tangents for a displacement of a known power, with all scratch space on the stack.
+   * @param vertices Vertices of the displacement, with positions filled in.
+   * @param textureInfo Texture info to derive tangents from.
+   */
+  template <size_t Power>
+  void generateInternalNormals(const std::span<Vertex> vertices, const Structs::TexInfo& textureInfo) {
+    using Grid = DisplacementGrid<Power>;
+
+    GridNormalScratch<std::array<float, getGridNormalPlaneSize(Grid::VERTICES_PER_AXIS)>> scratch;
+    std::array<Structs::Vector, Grid::VERTEX_COUNT> normals;
+    std::array<Structs::Vector4, Grid::VERTEX_COUNT> tangents;
+
+    generateGridNormals(Grid::VERTICES_PER_AXIS, vertices, scratch, normals);
+    calculateTangents(normals, textureInfo, tangents);
+
+    for (size_t i = 0; i < Grid::VERTEX_COUNT; i++) {
+      vertices[i].normal = normals[i];
+      vertices[i].tangent = tangents[i];
+    }
+  }
+
+  /**
+   * Generates triangle list indices for a displacement of a known power, in the same order as the generic path.
+   */
+  template <size_t Power, typename Iteratee>
+  void generateTriangleListIndices(const Iteratee& iteratee) {
+    using Grid = DisplacementGrid<Power>;
+    constexpr auto size = static_cast<uint32_t>(Grid::VERTICES_PER_AXIS - 1);
+
+    for (uint32_t x = 0; x < size; x++) {
+      for (uint32_t y = 0; y < size; y++) {
+        const auto bottomLeft = static_cast<uint32_t>(Grid::getVertexIndex(x, y));
+        const auto topLeft = static_cast<uint32_t>(Grid::getVertexIndex(x, y + 1));
+        const auto topRight = static_cast<uint32_t>(Grid::getVertexIndex(x + 1, y + 1));
+        const auto bottomRight = static_cast<uint32_t>(Grid::getVertexIndex(x + 1, y));
+
+        iteratee(bottomLeft, topLeft, topRight);
+        iteratee(bottomLeft, topRight, bottomRight);
+      }
+    }
+  }
+}
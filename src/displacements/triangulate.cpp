@@ -2,7 +2,9 @@
 #include "../helpers/calculate-uvs.hpp"
 #include "../helpers/get-vertex-position.hpp"
 #include "../helpers/vector-maths.hpp"
+#include "../limits.hpp"
 #include <algorithm>
+#include <array>
 
 namespace BspParser {
   using namespace Internal;
@@ -39,94 +41,141 @@ namespace BspParser {
       return remapped;
     }
 
-    Structs::Vector calculateTessellatedPosition(
-      const Structs::DispVert& displacementVertex,
-      const float edgeLengthFraction,
-      const std::array<Structs::Vector, 4>& corners,
-      const std::array<Structs::Vector, 2>& increments,
-      const size_t x,
-      const size_t y
-    ) {
-      const auto endPoints = std::array{
-        add(mul(increments[0], static_cast<float>(y)), corners[0]),
-        add(mul(increments[1], static_cast<float>(y)), corners[3]),
+    /**
+     * Value interpolated across the corners of a displacement a row at a time, so each row's end points are computed
+     * once rather than for every vertex.
+     */
+    template <typename T>
+    struct CornerInterpolation {
+      std::array<T, 4> corners;
+      std::array<T, 2> increments;
+
+      CornerInterpolation(const std::array<T, 4>& corners, const float edgeLengthFraction) :
+          corners(corners),
+          increments{
+            mul(sub(corners[1], corners[0]), edgeLengthFraction),
+            mul(sub(corners[2], corners[3]), edgeLengthFraction),
+          } {}
+
+      struct Row {
+        T start;
+        T step;
       };
 
-      const auto segment = sub(endPoints[1], endPoints[0]);
-      const auto segmentIncrement = mul(segment, edgeLengthFraction);
-      const auto segmentOffset = mul(segmentIncrement, static_cast<float>(x));
+      [[nodiscard]] Row getRow(const size_t y, const float edgeLengthFraction) const {
+        const auto start = add(mul(increments[0], static_cast<float>(y)), corners[0]);
+        const auto end = add(mul(increments[1], static_cast<float>(y)), corners[3]);
 
-      const auto displacementVector = mul(displacementVertex.vec, displacementVertex.dist);
+        return Row{
+          .start = start,
+          .step = mul(sub(end, start), edgeLengthFraction),
+        };
+      }
+    };
 
-      return add(add(endPoints[0], segmentOffset), displacementVector);
-    }
+    /**
+     * Attributes for a run of up to CAPACITY vertices in a row, split into separate planes so they can be computed
+     * with contiguous loads and stores before being scattered into the interleaved vertices.
+     */
+    struct RowScratch {
+      static constexpr size_t CAPACITY = (static_cast<size_t>(1) << Limits::MAX_MAP_DISP_POWER) + 1;
 
-    Structs::Vector2 calculateTessellatedUv(
-      const float edgeLengthFraction,
-      const std::array<Structs::Vector2, 4>& corners,
-      const std::array<Structs::Vector2, 2>& increments,
-      const size_t x,
-      const size_t y
-    ) {
-      const auto endPoints = std::array{
-        add(mul(increments[0], static_cast<float>(y)), corners[0]),
-        add(mul(increments[1], static_cast<float>(y)), corners[3]),
-      };
+      // Offset of each entry within a run, as converting the 64-bit index to float doesn't vectorise
+      static constexpr auto COLUMN_OFFSETS = [] {
+        std::array<float, CAPACITY> offsets{};
+
+        for (size_t i = 0; i < CAPACITY; i++) {
+          offsets[i] = static_cast<float>(i);
+        }
 
-      const auto segment = sub(endPoints[1], endPoints[0]);
-      const auto segmentIncrement = mul(segment, edgeLengthFraction);
-      const auto segmentOffset = mul(segmentIncrement, static_cast<float>(x));
+        return offsets;
+      }();
 
-      return add(endPoints[0], segmentOffset);
-    }
+      std::array<float, CAPACITY> x;
+      std::array<float, CAPACITY> y;
+      std::array<float, CAPACITY> z;
+      std::array<float, CAPACITY> u;
+      std::array<float, CAPACITY> v;
+      std::array<float, CAPACITY> lightmapU;
+      std::array<float, CAPACITY> lightmapV;
+    };
   }
 
   std::vector<Vertex> TriangulatedDisplacement::triangulate(
     const std::span<const Structs::DispVert> dispVertices,
     const std::span<const Structs::Edge> edges,
     const std::span<const Structs::Vector> vertices,
-    const std::span<const int32_t> surfaceEdges
+    const std::span<const int32_t> surfaceEdges,
+    const Structs::Face& face
   ) const {
     const auto edgeLengthFraction = 1.f / static_cast<float>(numVerticesPerAxis - 1);
 
     const auto dispVerticesForDisplacement =
       dispVertices.subspan(dispInfo.dispVertStart, numVerticesPerAxis * numVerticesPerAxis);
 
-    const auto cornerPositions = getCorners(dispInfo, edges, vertices, surfaceEdges);
-    const auto cornerUvs = std::array{
-      calculateUvs(cornerPositions[0], textureInfo, textureData),
-      calculateUvs(cornerPositions[1], textureInfo, textureData),
-      calculateUvs(cornerPositions[2], textureInfo, textureData),
-      calculateUvs(cornerPositions[3], textureInfo, textureData),
-    };
-
-    const auto positionIncrements = std::array{
-      mul(sub(cornerPositions[1], cornerPositions[0]), edgeLengthFraction),
-      mul(sub(cornerPositions[2], cornerPositions[3]), edgeLengthFraction),
-    };
-    const auto uvIncrements = std::array{
-      mul(sub(cornerUvs[1], cornerUvs[0]), edgeLengthFraction),
-      mul(sub(cornerUvs[2], cornerUvs[3]), edgeLengthFraction),
-    };
-
-    std::vector<Vertex> triangulatedVertices;
-    triangulatedVertices.reserve(numVerticesPerAxis * numVerticesPerAxis);
+    const auto positions =
+      CornerInterpolation<Structs::Vector>(getCorners(dispInfo, edges, vertices, surfaceEdges), edgeLengthFraction);
+    const auto& cornerPositions = positions.corners;
+    const auto uvs = CornerInterpolation<Structs::Vector2>(
+      {
+        calculateUvs(cornerPositions[0], textureInfo, textureData),
+        calculateUvs(cornerPositions[1], textureInfo, textureData),
+        calculateUvs(cornerPositions[2], textureInfo, textureData),
+        calculateUvs(cornerPositions[3], textureInfo, textureData),
+      },
+      edgeLengthFraction
+    );
+    const auto lightmapUvs = CornerInterpolation<Structs::Vector2>(
+      {
+        calculateLightmapUvs(cornerPositions[0], textureInfo, face),
+        calculateLightmapUvs(cornerPositions[1], textureInfo, face),
+        calculateLightmapUvs(cornerPositions[2], textureInfo, face),
+        calculateLightmapUvs(cornerPositions[3], textureInfo, face),
+      },
+      edgeLengthFraction
+    );
+
+    std::vector<Vertex> triangulatedVertices(numVerticesPerAxis * numVerticesPerAxis);
+    RowScratch scratch;
 
     for (size_t y = 0; y < numVerticesPerAxis; y++) {
-      for (size_t x = 0; x < numVerticesPerAxis; x++) {
-        const auto& displacementVertex = dispVerticesForDisplacement[y * numVerticesPerAxis + x];
-
-        triangulatedVertices.push_back(
-          Vertex{
-            .position = calculateTessellatedPosition(
-              displacementVertex, edgeLengthFraction, cornerPositions, positionIncrements, x, y
-            ),
-            .normal = Structs::Vector{},
-            .tangent = Structs::Vector4{},
-            .uv = calculateTessellatedUv(edgeLengthFraction, cornerUvs, uvIncrements, x, y),
-            .alpha = std::clamp(displacementVertex.alpha / 255.f, 0.f, 1.f),
-          }
-        );
+      const auto positionRow = positions.getRow(y, edgeLengthFraction);
+      const auto uvRow = uvs.getRow(y, edgeLengthFraction);
+      const auto lightmapUvRow = lightmapUvs.getRow(y, edgeLengthFraction);
+
+      // Legal powers fit a row in one run, larger ones are handled a run at a time
+      for (size_t first = 0; first < numVerticesPerAxis; first += RowScratch::CAPACITY) {
+        const auto count = std::min(RowScratch::CAPACITY, numVerticesPerAxis - first);
+        const auto rowStart = y * numVerticesPerAxis + first;
+        const auto displacementVertices = dispVerticesForDisplacement.subspan(rowStart, count);
+        const auto vertexRun = std::span(triangulatedVertices).subspan(rowStart, count);
+        const auto firstColumn = static_cast<float>(first);
+
+        for (size_t x = 0; x < count; x++) {
+          const auto column = firstColumn + RowScratch::COLUMN_OFFSETS[x];
+
+          scratch.x[x] = positionRow.start.x + positionRow.step.x * column;
+          scratch.y[x] = positionRow.start.y + positionRow.step.y * column;
+          scratch.z[x] = positionRow.start.z + positionRow.step.z * column;
+          scratch.u[x] = uvRow.start.x + uvRow.step.x * column;
+          scratch.v[x] = uvRow.start.y + uvRow.step.y * column;
+          scratch.lightmapU[x] = lightmapUvRow.start.x + lightmapUvRow.step.x * column;
+          scratch.lightmapV[x] = lightmapUvRow.start.y + lightmapUvRow.step.y * column;
+        }
+
+        // Displacement vertices are interleaved too, so their offsets and alpha are applied while scattering
+        for (size_t x = 0; x < count; x++) {
+          const auto& displacementVertex = displacementVertices[x];
+          auto& vertex = vertexRun[x];
+
+          vertex.position = add(
+            Structs::Vector{scratch.x[x], scratch.y[x], scratch.z[x]},
+            mul(displacementVertex.vec, displacementVertex.dist)
+          );
+          vertex.uv = Structs::Vector2{scratch.u[x], scratch.v[x]};
+          vertex.lightmapUv = Structs::Vector2{scratch.lightmapU[x], scratch.lightmapV[x]};
+          vertex.alpha = std::clamp(displacementVertex.alpha / 255.f, 0.f, 1.f);
+        }
       }
     }
 
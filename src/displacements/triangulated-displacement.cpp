@@ -1,4 +1,5 @@
 #include "triangulated-displacement.hpp"
+#include "power-kernels.hpp"
 
 namespace BspParser {
   namespace {
@@ -21,6 +22,7 @@ namespace BspParser {
     const std::span<const Structs::Edge> edges,
     const std::span<const Structs::Vector> vertices,
     const std::span<const int32_t> surfaceEdges,
+    const Structs::Face& face,
     const Structs::TexInfo& textureInfo,
     const Structs::TexData& textureData
   ) : dispInfo(dispInfo), textureInfo(textureInfo), textureData(textureData) {
@@ -31,7 +33,7 @@ namespace BspParser {
       cornerNeighbours[neighbourIndex] = getCornerNeighbours(dispInfo.cornerNeighbours[neighbourIndex]);
     }
 
-    this->vertices = triangulate(dispVertices, edges, vertices, surfaceEdges);
+    this->vertices = triangulate(dispVertices, edges, vertices, surfaceEdges, face);
     generateInternalNormals();
   }
 
@@ -47,6 +49,14 @@ namespace BspParser {
   void TriangulatedDisplacement::generateTriangleListIndices(
     const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
   ) const {
+    const auto dispatched = Internal::dispatchDisplacementPower(dispInfo.power, [&iteratee](const auto power) {
+      Internal::generateTriangleListIndices<decltype(power)::value>(iteratee);
+    });
+
+    if (dispatched) {
+      return;
+    }
+
     const auto size = numVerticesPerAxis - 1;
 
     for (uint32_t x = 0; x < size; x++) {
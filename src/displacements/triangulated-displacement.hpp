@@ -30,6 +30,7 @@ namespace BspParser {
       std::span<const Structs::Edge> edges,
       std::span<const Structs::Vector> vertices,
       std::span<const int32_t> surfaceEdges,
+      const Structs::Face& face,
       const Structs::TexInfo& textureInfo,
       const Structs::TexData& textureData
     );
@@ -45,19 +46,54 @@ namespace BspParser {
     std::array<Structs::DispNeighbour, 4> edgeNeighbours;
     std::array<std::vector<uint16_t>, 4> cornerNeighbours;
 
+    /**
+     * Normals and tangents from before blending with neighbouring displacements, so blending can be redone.
+     * Empty until the displacement is first blended.
+     */
+    std::vector<Structs::Vector> unblendedNormals;
+    std::vector<Structs::Vector4> unblendedTangents;
+
     [[nodiscard]] size_t getTriangleListIndexCount() const;
     void generateTriangleListIndices(const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee) const;
 
+    /**
+     * Most reductions in power allowed by the displacement's power and minimum tessellation.
+     */
+    [[nodiscard]] uint8_t getMaxLod() const;
+
+    /**
+     * Whether a vertex may be used when reducing detail, from DispInfo::allowedVertices.
+     * Edge vertices a lower power neighbour lacks are disallowed, as using them would leave T-junctions.
+     */
+    [[nodiscard]] bool isVertexAllowed(size_t x, size_t y) const;
+
+    /**
+     * Number of indices generateLodTriangleListIndices emits for a level of detail.
+     */
+    [[nodiscard]] size_t getLodTriangleListIndexCount(uint8_t lod) const;
+
+    /**
+     * Generates indices into vertices for the displacement with its power reduced by lod, so each level's interior has
+     * a quarter of the triangles of the one before. Edges keep every allowed vertex and are stitched into the coarser
+     * interior, so displacements at any mix of levels meet without cracks.
+     * @param lod Number of power reductions, where 0 is full detail.
+     * @param iteratee Function called with each triangle, clockwise like generateTriangleListIndices.
+     * @throws std::invalid_argument lod exceeds getMaxLod.
+     */
+    void generateLodTriangleListIndices(
+      uint8_t lod, const std::function<void(uint32_t i0, uint32_t i1, uint32_t i2)>& iteratee
+    ) const;
+
   private:
     [[nodiscard]] std::vector<Vertex> triangulate(
       std::span<const Structs::DispVert> dispVertices,
       std::span<const Structs::Edge> edges,
       std::span<const Structs::Vector> vertices,
-      std::span<const int32_t> surfaceEdges
+      std::span<const int32_t> surfaceEdges,
+      const Structs::Face& face
     ) const;
 
     void generateInternalNormals();
-    [[nodiscard]] Structs::Vector generateInternalNormal(size_t x, size_t y) const;
 
     [[nodiscard]] size_t getVertexIndex(size_t x, size_t y) const;
     [[nodiscard]] const Vertex& getVertex(size_t x, size_t y) const;
@@ -0,0 +1,91 @@
+#include "entity.hpp"
+#include <array>
+#include <charconv>
+
+namespace BspParser {
+  namespace {
+    std::optional<std::array<float, 3>> parseFloat3(const std::string_view value) {
+      std::array<float, 3> result{};
+
+      const auto* current = value.data();
+      const auto* const end = value.data() + value.size();
+
+      for (auto& component : result) {
+        while (current < end && (*current == ' ' || *current == '\t')) {
+          current++;
+        }
+
+        const auto [next, error] = std::from_chars(current, end, component);
+        if (error != std::errc()) {
+          return std::nullopt;
+        }
+
+        current = next;
+      }
+
+      return result;
+    }
+  }
+
+  std::optional<std::string_view> Entity::getValue(const std::string_view key) const {
+    for (const auto& keyValue : keyValues) {
+      if (keyValue.key == key) {
+        return keyValue.value;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  std::string_view Entity::getClassName() const {
+    return getValue("classname").value_or(std::string_view());
+  }
+
+  std::string_view Entity::getTargetName() const {
+    return getValue("targetname").value_or(std::string_view());
+  }
+
+  std::optional<Structs::Vector> Entity::getOrigin() const {
+    const auto value = getValue("origin");
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+
+    const auto components = parseFloat3(value.value());
+    if (!components.has_value()) {
+      return std::nullopt;
+    }
+
+    return Structs::Vector{.x = components->at(0), .y = components->at(1), .z = components->at(2)};
+  }
+
+  std::optional<Structs::EulerRotation> Entity::getAngles() const {
+    const auto value = getValue("angles");
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+
+    const auto components = parseFloat3(value.value());
+    if (!components.has_value()) {
+      return std::nullopt;
+    }
+
+    return Structs::EulerRotation{.x = components->at(0), .y = components->at(1), .z = components->at(2)};
+  }
+
+  std::optional<int32_t> Entity::getBrushModelIndex() const {
+    const auto value = getValue("model");
+    if (!value.has_value() || value->size() < 2 || value->front() != '*') {
+      return std::nullopt;
+    }
+
+    int32_t modelIndex = 0;
+    const auto* const end = value->data() + value->size();
+    const auto [next, error] = std::from_chars(value->data() + 1, end, modelIndex);
+    if (error != std::errc() || next != end) {
+      return std::nullopt;
+    }
+
+    return modelIndex;
+  }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../structs/common.hpp"
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Key/value pair of an entity.
+   * @note Both views point directly into the entity lump and are not null-terminated.
+   */
+  struct EntityKeyValue {
+    std::string_view key;
+    std::string_view value;
+  };
+
+  /**
+   * Single entity parsed from the entity lump.
+   */
+  struct Entity {
+    /**
+     * Key/value pairs in the order they appear in the lump. Keys may repeat (e.g. entity outputs).
+     */
+    std::vector<EntityKeyValue> keyValues;
+
+    /**
+     * Returns the value of the first key/value pair with the given key.
+     * @param key Case-sensitive key to search for.
+     * @return Value if the key exists.
+     */
+    [[nodiscard]] std::optional<std::string_view> getValue(std::string_view key) const;
+
+    /**
+     * @return Value of the classname key, or an empty view if missing.
+     */
+    [[nodiscard]] std::string_view getClassName() const;
+
+    /**
+     * @return Value of the targetname key, or an empty view if missing.
+     */
+    [[nodiscard]] std::string_view getTargetName() const;
+
+    /**
+     * Parses the origin key without allocating.
+     * @return Origin if the key exists and contains three numbers.
+     */
+    [[nodiscard]] std::optional<Structs::Vector> getOrigin() const;
+
+    /**
+     * Parses the angles key without allocating.
+     * @return Angles (pitch, yaw, roll) if the key exists and contains three numbers.
+     */
+    [[nodiscard]] std::optional<Structs::EulerRotation> getAngles() const;
+
+    /**
+     * Parses brush model references of the form "*N" from the model key.
+     * @return Index into the model lump if the entity references a brush model.
+     */
+    [[nodiscard]] std::optional<int32_t> getBrushModelIndex() const;
+  };
+}
@@ -0,0 +1,109 @@
+#include "parse-entities.hpp"
+#include "../errors.hpp"
+#include "../limits.hpp"
+#include <cstring>
+#include <format>
+
+namespace BspParser::Internal {
+  namespace {
+    bool isWhitespace(const char character) {
+      return character == ' ' || character == '\n' || character == '\r' || character == '\t';
+    }
+
+    size_t skipWhitespace(const std::string_view data, size_t offset) {
+      while (offset < data.size() && isWhitespace(data[offset])) {
+        offset++;
+      }
+
+      return offset;
+    }
+
+    std::string_view readQuotedString(const std::string_view data, size_t& offset) {
+      if (offset >= data.size() || data[offset] != '"') {
+        throw Errors::InvalidBody(
+          Enums::Lump::Entities, std::format("Expected opening quote at offset {} of the entity lump", offset)
+        );
+      }
+
+      // Keys and values cannot contain quotes, so the bulk of tokenising is a single memchr over the string
+      const auto* const start = data.data() + offset + 1;
+      const auto* const closingQuote = static_cast<const char*>(std::memchr(start, '"', data.size() - offset - 1));
+      if (closingQuote == nullptr) {
+        throw Errors::InvalidBody(
+          Enums::Lump::Entities, std::format("String starting at offset {} of the entity lump is unterminated", offset)
+        );
+      }
+
+      offset = closingQuote - data.data() + 1;
+      return {start, static_cast<size_t>(closingQuote - start)};
+    }
+  }
+
+  std::vector<Entity> parseEntities(const std::span<const char> entityData) {
+    auto data = std::string_view(entityData.data(), entityData.size());
+    if (const auto terminator = data.find('\0'); terminator != std::string_view::npos) {
+      data = data.substr(0, terminator);
+    }
+
+    std::vector<Entity> entities;
+
+    size_t offset = skipWhitespace(data, 0);
+    while (offset < data.size()) {
+      if (data[offset] != '{') {
+        throw Errors::InvalidBody(
+          Enums::Lump::Entities, std::format("Expected '{{' at offset {} of the entity lump", offset)
+        );
+      }
+
+      if (entities.size() >= Limits::MAX_MAP_ENTITIES) {
+        throw Errors::InvalidBody(
+          Enums::Lump::Entities,
+          std::format("Number of entities exceeds source engine maximum ({})", Limits::MAX_MAP_ENTITIES)
+        );
+      }
+
+      const auto entityStart = offset;
+      offset = skipWhitespace(data, offset + 1);
+
+      auto& entity = entities.emplace_back();
+      while (true) {
+        if (offset >= data.size()) {
+          throw Errors::InvalidBody(
+            Enums::Lump::Entities,
+            std::format("Entity starting at offset {} of the entity lump is not closed", entityStart)
+          );
+        }
+
+        if (data[offset] == '}') {
+          break;
+        }
+
+        const auto key = readQuotedString(data, offset);
+        offset = skipWhitespace(data, offset);
+        const auto value = readQuotedString(data, offset);
+        offset = skipWhitespace(data, offset);
+
+        entity.keyValues.push_back(EntityKeyValue{.key = key, .value = value});
+      }
+
+      offset = skipWhitespace(data, offset + 1);
+    }
+
+    return entities;
+  }
+
+  std::unordered_map<std::string_view, std::vector<size_t>> indexEntitiesByKey(
+    const std::span<const Entity> entities, const std::string_view key
+  ) {
+    std::unordered_map<std::string_view, std::vector<size_t>> index;
+
+    for (size_t entityIndex = 0; entityIndex < entities.size(); entityIndex++) {
+      const auto value = entities[entityIndex].getValue(key);
+      if (value.has_value()) {
+        index[value.value()].push_back(entityIndex);
+      }
+    }
+
+    return index;
+  }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "entity.hpp"
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace BspParser::Internal {
+  /**
+   * Tokenises the entity lump into entities whose keys and values view the lump directly.
+   * @param entityData Raw entity lump, optionally null-terminated.
+   * @return Parsed entities in lump order.
+   * @throws Errors::InvalidBody The lump is malformed.
+   */
+  std::vector<Entity> parseEntities(std::span<const char> entityData);
+
+  /**
+   * Groups entity indices by the value of the given key. Entities without the key are not indexed.
+   */
+  std::unordered_map<std::string_view, std::vector<size_t>> indexEntitiesByKey(
+    std::span<const Entity> entities, std::string_view key
+  );
+}
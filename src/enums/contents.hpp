@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BspParser::Enums {
+  // Size is excessive but matches width in the file
+  enum class Contents : int32_t { // NOLINT(*-enum-size)
+    Empty = 0x0,
+    Solid = 0x1,
+    Window = 0x2,
+    Aux = 0x4,
+    Grate = 0x8,
+    Slime = 0x10,
+    Water = 0x20,
+    BlockLos = 0x40,
+    Opaque = 0x80,
+    TestFogVolume = 0x100,
+    Team1 = 0x800,
+    Team2 = 0x1000,
+    IgnoreNoDrawOpaque = 0x2000,
+    Moveable = 0x4000,
+    AreaPortal = 0x8000,
+    PlayerClip = 0x10000,
+    MonsterClip = 0x20000,
+    Current0 = 0x40000,
+    Current90 = 0x80000,
+    Current180 = 0x100000,
+    Current270 = 0x200000,
+    CurrentUp = 0x400000,
+    CurrentDown = 0x800000,
+    Origin = 0x1000000,
+    Monster = 0x2000000,
+    Debris = 0x4000000,
+    Detail = 0x8000000,
+    Translucent = 0x10000000,
+    Ladder = 0x20000000,
+    Hitbox = 0x40000000
+  };
+
+  inline Contents operator|(Contents lhs, Contents rhs) {
+    return static_cast<Contents>(static_cast<int32_t>(lhs) | static_cast<int32_t>(rhs));
+  }
+
+  inline Contents& operator|=(Contents& lhs, const Contents rhs) {
+    lhs = lhs | rhs;
+    return lhs;
+  }
+
+  inline Contents operator&(Contents lhs, Contents rhs) {
+    return static_cast<Contents>(static_cast<int32_t>(lhs) & static_cast<int32_t>(rhs));
+  }
+
+  inline Contents& operator&=(Contents& lhs, const Contents rhs) {
+    lhs = lhs & rhs;
+    return lhs;
+  }
+}
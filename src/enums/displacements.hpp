@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BspParser::Enums {
+  enum class DispTriFlag : uint16_t {
+    None = 0x0,
+    Surface = 0x1,
+    Walkable = 0x2,
+    Buildable = 0x4,
+    SurfaceProp1 = 0x8, // Uses the material's second surface prop
+    SurfaceProp2 = 0x10, // Uses the material's third surface prop
+    Remove = 0x20, // Removed from collision
+  };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BspParser::Enums {
+  enum class EmitType : int32_t {
+    Surface = 0, // 90 degree spotlight
+    Point,
+    Spotlight,
+    Skylight, // Directional light with no falloff (surface must trace to SKY texture)
+    QuakeLight, // Linear falloff, non-lambertian
+    SkyAmbient, // Spherical light source with no falloff (surface must trace to SKY texture)
+  };
+
+  enum class WorldLightFlag : int32_t {
+    None = 0,
+    InAmbientCube = 0x1, // This light is already baked into the ambient cube
+  };
+}
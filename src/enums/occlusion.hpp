@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BspParser::Enums {
+  enum class OccluderFlag : int32_t {
+    None = 0,
+    Inactive = 0x1, // Disabled by the func_occluder entity's StartActive keyvalue
+  };
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BspParser::Enums {
+  enum class PrimitiveType : uint8_t {
+    TriangleList = 0,
+    TriangleStrip,
+  };
+}
@@ -1,5 +1,6 @@
 #include "calculate-tangent.hpp"
 #include "vector-maths.hpp"
+#include <cmath>
 
 namespace BspParser::Internal {
   Structs::Vector4 calculateTangent(const Structs::Vector& normal, const Structs::TexInfo& textureInfo) {
@@ -17,4 +18,38 @@ namespace BspParser::Internal {
       .w = handedness,
     };
   }
+
+  void calculateTangents(
+    const std::span<const Structs::Vector> normals,
+    const Structs::TexInfo& textureInfo,
+    const std::span<Structs::Vector4> tangents
+  ) {
+    const auto sAxis = xyz(textureInfo.textureVecs[0]);
+    const auto tAxis = xyz(textureInfo.textureVecs[1]);
+
+    // Same maths as calculateTangent, written out with no branches so the loop vectorises
+    for (size_t i = 0; i < normals.size(); i++) {
+      const auto& normal = normals[i];
+      const auto projection = normal.x * sAxis.x + normal.y * sAxis.y + normal.z * sAxis.z;
+
+      const auto x = sAxis.x - normal.x * projection;
+      const auto y = sAxis.y - normal.y * projection;
+      const auto z = sAxis.z - normal.z * projection;
+      const auto inverseLength = 1.f / std::sqrt(x * x + y * y + z * z);
+
+      const auto tangentX = x * inverseLength;
+      const auto tangentY = y * inverseLength;
+      const auto tangentZ = z * inverseLength;
+
+      const auto bitangentDotT = (normal.y * tangentZ - normal.z * tangentY) * tAxis.x +
+        (normal.z * tangentX - normal.x * tangentZ) * tAxis.y + (normal.x * tangentY - normal.y * tangentX) * tAxis.z;
+
+      tangents[i] = Structs::Vector4{
+        .x = tangentX,
+        .y = tangentY,
+        .z = tangentZ,
+        .w = bitangentDotT < 0.f ? -1.f : 1.f,
+      };
+    }
+  }
 }
@@ -2,7 +2,18 @@
 
 #include "../structs/common.hpp"
 #include "../structs/textures.hpp"
+#include <span>
 
 namespace BspParser::Internal {
   Structs::Vector4 calculateTangent(const Structs::Vector& normal, const Structs::TexInfo& textureInfo);
+
+  /**
+   * Batched calculateTangent, orthogonalising the texture's S axis against each normal.
+   * @param normals Unit normals.
+   * @param textureInfo Texture info providing the S and T axes.
+   * @param tangents Receives a tangent per normal. Must be at least normals.size() long.
+   */
+  void calculateTangents(
+    std::span<const Structs::Vector> normals, const Structs::TexInfo& textureInfo, std::span<Structs::Vector4> tangents
+  );
 }
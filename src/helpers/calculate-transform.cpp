@@ -0,0 +1,56 @@
+#include "calculate-transform.hpp"
+#include "sin-cos.hpp"
+#include <algorithm>
+#include <array>
+#include <numbers>
+
+namespace BspParser::Internal {
+  void calculateTransforms(
+    const std::span<const Structs::Vector> origins,
+    const std::span<const Structs::EulerRotation> angles,
+    const std::span<Matrix3x4> transforms
+  ) {
+    constexpr auto degreesToRadians = std::numbers::pi_v<float> / 180.f;
+
+    // Angles are transposed into fixed-size stack buffers so the trig runs as one vectorised pass per chunk
+    constexpr size_t chunkSize = 64;
+    constexpr size_t numAxes = 3;
+
+    std::array<float, chunkSize * numAxes> radians{};
+    std::array<float, chunkSize * numAxes> sines{};
+    std::array<float, chunkSize * numAxes> cosines{};
+
+    for (size_t chunkStart = 0; chunkStart < transforms.size(); chunkStart += chunkSize) {
+      const auto count = std::min(chunkSize, transforms.size() - chunkStart);
+
+      for (size_t i = 0; i < count; i++) {
+        const auto& rotation = angles[chunkStart + i];
+        radians[i] = rotation.x * degreesToRadians;
+        radians[chunkSize + i] = rotation.y * degreesToRadians;
+        radians[chunkSize * 2 + i] = rotation.z * degreesToRadians;
+      }
+
+      sinCos(radians, sines, cosines);
+
+      for (size_t i = 0; i < count; i++) {
+        const auto& origin = origins[chunkStart + i];
+
+        const auto sp = sines[i];
+        const auto cp = cosines[i];
+        const auto sy = sines[chunkSize + i];
+        const auto cy = cosines[chunkSize + i];
+        const auto sr = sines[chunkSize * 2 + i];
+        const auto cr = cosines[chunkSize * 2 + i];
+
+        // Matches AngleMatrix from the Source SDK's mathlib
+        transforms[chunkStart + i] = Matrix3x4{
+          .rows = {
+            Structs::Vector4{cp * cy, sp * sr * cy - cr * sy, sp * cr * cy + sr * sy, origin.x},
+            Structs::Vector4{cp * sy, sp * sr * sy + cr * cy, sp * cr * sy - sr * cy, origin.y},
+            Structs::Vector4{-sp, sr * cp, cr * cp, origin.z},
+          },
+        };
+      }
+    }
+  }
+}
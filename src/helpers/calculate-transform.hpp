@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../matrix.hpp"
+#include "../structs/common.hpp"
+#include <span>
+
+namespace BspParser::Internal {
+  /**
+   * Builds transforms from Source engine (pitch, yaw, roll) angles in degrees and origins.
+   * @param origins Translation of each transform.
+   * @param angles Rotation of each transform. Must be the same length as origins.
+   * @param transforms Output transforms. Must be the same length as origins.
+   */
+  void calculateTransforms(
+    std::span<const Structs::Vector> origins,
+    std::span<const Structs::EulerRotation> angles,
+    std::span<Matrix3x4> transforms
+  );
+}
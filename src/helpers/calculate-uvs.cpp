@@ -13,4 +13,20 @@ namespace BspParser::Internal {
       .v = (dot(xyz(tAxis), position) + tAxis.w) / static_cast<float>(textureData.height),
     };
   }
+
+  Structs::Vector2 calculateLightmapUvs(
+    const Structs::Vector& position, const Structs::TexInfo& textureInfo, const Structs::Face& face
+  ) {
+    const auto& sAxis = textureInfo.lightmapVecs[0];
+    const auto& tAxis = textureInfo.lightmapVecs[1];
+
+    const auto mins = face.lightmapTextureMinsInLuxels;
+    const auto size = face.lightmapTextureSizeInLuxels;
+
+    // Luxel coordinates are offset by half a luxel to sample luxel centres, matching the engine
+    return Structs::Vector2{
+      .u = (dot(xyz(sAxis), position) + sAxis.w - static_cast<float>(mins[0]) + 0.5f) / static_cast<float>(size[0] + 1),
+      .v = (dot(xyz(tAxis), position) + tAxis.w - static_cast<float>(mins[1]) + 0.5f) / static_cast<float>(size[1] + 1),
+    };
+  }
 }
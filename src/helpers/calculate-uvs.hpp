@@ -1,10 +1,15 @@
 #pragma once
 
 #include "../structs/common.hpp"
+#include "../structs/geometry.hpp"
 #include "../structs/textures.hpp"
 
 namespace BspParser::Internal {
   Structs::Vector2 calculateUvs(
     const Structs::Vector& position, const Structs::TexInfo& textureInfo, const Structs::TexData& textureData
   );
+
+  Structs::Vector2 calculateLightmapUvs(
+    const Structs::Vector& position, const Structs::TexInfo& textureInfo, const Structs::Face& face
+  );
 }
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace BspParser::Internal {
+  /**
+   * Calls function(i) for every i in [0, count), splitting the range into contiguous blocks across hardware threads.
+   * Small ranges run on the calling thread. If any call throws, the first block's exception is rethrown once
+   * every thread has finished, and the rest of that block is skipped.
+   * @warning function must be safe to call concurrently for different indices.
+   */
+  template <typename Function>
+  void parallelFor(const size_t count, const Function& function, const size_t minItemsPerThread = 1024) {
+    const auto hardwareThreads = static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    const auto numThreads = std::min(hardwareThreads, (count + minItemsPerThread - 1) / minItemsPerThread);
+
+    if (numThreads <= 1) {
+      for (size_t i = 0; i < count; i++) {
+        function(i);
+      }
+      return;
+    }
+
+    const auto blockSize = (count + numThreads - 1) / numThreads;
+    std::vector<std::exception_ptr> exceptions(numThreads);
+
+    const auto runBlock = [&function, &exceptions, blockSize, count](const size_t block) {
+      try {
+        for (size_t i = block * blockSize; i < std::min((block + 1) * blockSize, count); i++) {
+          function(i);
+        }
+      } catch (...) {
+        exceptions[block] = std::current_exception();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (size_t block = 1; block < numThreads; block++) {
+      threads.emplace_back(runBlock, block);
+    }
+
+    runBlock(0);
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (const auto& exception : exceptions) {
+      if (exception) {
+        std::rethrow_exception(exception);
+      }
+    }
+  }
+}
@@ -0,0 +1,43 @@
+#include "sin-cos.hpp"
+#include <cstdint>
+#include <numbers>
+
+namespace BspParser::Internal {
+  void sinCos(const std::span<const float> radians, const std::span<float> sines, const std::span<float> cosines) {
+    constexpr auto twoOverPi = 2.f / std::numbers::pi_v<float>;
+
+    // Cody-Waite split of pi/2 (from Cephes) so the range reduction stays exact for large inputs
+    constexpr auto halfPi1 = 1.5703125f;
+    constexpr auto halfPi2 = 4.837512969970703125e-4f;
+    constexpr auto halfPi3 = 7.54978995489188216e-8f;
+
+    const auto count = radians.size();
+    const auto* const input = radians.data();
+    auto* const sinOutput = sines.data();
+    auto* const cosOutput = cosines.data();
+
+    for (size_t i = 0; i < count; i++) {
+      const auto x = input[i];
+
+      const auto quadrant = static_cast<int32_t>(x * twoOverPi + (x < 0.f ? -0.5f : 0.5f));
+      const auto quadrantFloat = static_cast<float>(quadrant);
+      const auto r = ((x - quadrantFloat * halfPi1) - quadrantFloat * halfPi2) - quadrantFloat * halfPi3;
+      const auto r2 = r * r;
+
+      // Minimax polynomials over [-pi/4, pi/4]
+      const auto sinR = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+      const auto cosR = 1.f - 0.5f * r2 +
+        r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+      const auto swap = (quadrant & 1) != 0;
+      const auto sinNegative = (quadrant & 2) != 0;
+      const auto cosNegative = ((quadrant + 1) & 2) != 0;
+
+      const auto sinValue = swap ? cosR : sinR;
+      const auto cosValue = swap ? sinR : cosR;
+
+      sinOutput[i] = sinNegative ? -sinValue : sinValue;
+      cosOutput[i] = cosNegative ? -cosValue : cosValue;
+    }
+  }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <span>
+
+namespace BspParser::Internal {
+  /**
+   * Computes the sine and cosine of each angle in radians.
+   * Branch-free polynomial approximation (accurate to a few ULP for game-world angles) which compilers auto-vectorise,
+   * unlike calls to std::sin and std::cos.
+   * @param radians Input angles.
+   * @param sines Output sines. Must be the same length as radians.
+   * @param cosines Output cosines. Must be the same length as radians.
+   */
+  void sinCos(std::span<const float> radians, std::span<float> sines, std::span<float> cosines);
+}
@@ -0,0 +1,182 @@
+#include "spatial-grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace BspParser::Internal {
+  namespace {
+    std::array<float, 3> toArray(const Structs::Vector& v) {
+      return {v.x, v.y, v.z};
+    }
+  }
+
+  SpatialGrid::SpatialGrid(
+    const std::span<const Structs::Vector> mins, const std::span<const Structs::Vector> maxs, const float requestedCellSize
+  ) :
+    itemMins(mins.begin(), mins.end()), itemMaxs(maxs.begin(), maxs.end()), cellSize(requestedCellSize) {
+    if (itemMins.empty()) {
+      return;
+    }
+
+    boundsMin = toArray(itemMins.front());
+    boundsMax = toArray(itemMaxs.front());
+    for (size_t item = 1; item < itemMins.size(); item++) {
+      const auto itemMin = toArray(itemMins[item]);
+      const auto itemMax = toArray(itemMaxs[item]);
+
+      for (size_t axis = 0; axis < 3; axis++) {
+        boundsMin[axis] = std::min(boundsMin[axis], itemMin[axis]);
+        boundsMax[axis] = std::max(boundsMax[axis], itemMax[axis]);
+      }
+    }
+
+    std::array<float, 3> extents{};
+    for (size_t axis = 0; axis < 3; axis++) {
+      extents[axis] = std::max(boundsMax[axis] - boundsMin[axis], 1.f);
+    }
+
+    if (cellSize <= 0.f) {
+      // Aim for roughly one item per cell
+      cellSize = std::cbrt(extents[0] * extents[1] * extents[2] / static_cast<float>(itemMins.size()));
+    }
+
+    // Degenerate distributions (e.g. everything on one plane) would otherwise explode the cell count
+    const auto maxCells = itemMins.size() * 4 + 64;
+    while (true) {
+      size_t numCells = 1;
+      for (size_t axis = 0; axis < 3; axis++) {
+        dimensions[axis] = static_cast<int32_t>(std::min(extents[axis] / cellSize, 1024.f)) + 1;
+        numCells *= dimensions[axis];
+      }
+
+      if (numCells <= maxCells) {
+        break;
+      }
+
+      cellSize *= 2.f;
+    }
+
+    const auto numCells = static_cast<size_t>(dimensions[0]) * dimensions[1] * dimensions[2];
+    cellStarts.assign(numCells + 1, 0);
+
+    const auto forEachOverlappedCell = [this](const uint32_t item, const auto& function) {
+      const auto first = getCellCoordinate(toArray(itemMins[item]));
+      const auto last = getCellCoordinate(toArray(itemMaxs[item]));
+
+      for (int32_t z = first[2]; z <= last[2]; z++) {
+        for (int32_t y = first[1]; y <= last[1]; y++) {
+          for (int32_t x = first[0]; x <= last[0]; x++) {
+            function(getCellIndex({x, y, z}));
+          }
+        }
+      }
+    };
+
+    for (uint32_t item = 0; item < itemMins.size(); item++) {
+      forEachOverlappedCell(item, [this](const size_t cell) { cellStarts[cell + 1]++; });
+    }
+
+    for (size_t cell = 0; cell < numCells; cell++) {
+      cellStarts[cell + 1] += cellStarts[cell];
+    }
+
+    cellItems.resize(cellStarts.back());
+    auto cursors = std::vector(cellStarts.begin(), cellStarts.end() - 1);
+    for (uint32_t item = 0; item < itemMins.size(); item++) {
+      forEachOverlappedCell(item, [this, &cursors, item](const size_t cell) { cellItems[cursors[cell]++] = item; });
+    }
+  }
+
+  size_t SpatialGrid::queryNearest(
+    const Structs::Vector& point, const std::span<uint32_t> output, const float maxDistance
+  ) const {
+    if (itemMins.empty() || output.empty()) {
+      return 0;
+    }
+
+    const auto maxDistanceSquared = maxDistance == std::numeric_limits<float>::max() ? maxDistance
+                                                                                     : maxDistance * maxDistance;
+
+    size_t numFound = 0;
+    const auto worstDistanceSquared = [&]() {
+      return numFound < output.size() ? maxDistanceSquared : getDistanceSquared(output[numFound - 1], point);
+    };
+
+    const auto centre = getCellCoordinate(toArray(point));
+    const auto maxRing = std::max({dimensions[0], dimensions[1], dimensions[2]});
+
+    for (int32_t ring = 0; ring <= maxRing; ring++) {
+      // Every cell in this ring is at least (ring - 1) cells away from the point on some axis
+      const auto ringDistance = static_cast<float>(std::max(ring - 1, 0)) * cellSize;
+      if (ringDistance * ringDistance > worstDistanceSquared()) {
+        break;
+      }
+
+      for (int32_t z = std::max(centre[2] - ring, 0); z <= std::min(centre[2] + ring, dimensions[2] - 1); z++) {
+        for (int32_t y = std::max(centre[1] - ring, 0); y <= std::min(centre[1] + ring, dimensions[1] - 1); y++) {
+          for (int32_t x = std::max(centre[0] - ring, 0); x <= std::min(centre[0] + ring, dimensions[0] - 1); x++) {
+            const auto onRing = std::abs(x - centre[0]) == ring || std::abs(y - centre[1]) == ring ||
+              std::abs(z - centre[2]) == ring;
+            if (!onRing) {
+              continue;
+            }
+
+            const auto cell = getCellIndex({x, y, z});
+            for (auto itemIndex = cellStarts[cell]; itemIndex < cellStarts[cell + 1]; itemIndex++) {
+              const auto item = cellItems[itemIndex];
+              const auto distanceSquared = getDistanceSquared(item, point);
+              if (distanceSquared > worstDistanceSquared()) {
+                continue;
+              }
+
+              if (std::find(output.begin(), output.begin() + numFound, item) != output.begin() + numFound) {
+                continue;
+              }
+
+              // Insertion sort into the caller's buffer, dropping the furthest item once full
+              auto insertAt = std::min(numFound, output.size() - 1);
+              while (insertAt > 0 && getDistanceSquared(output[insertAt - 1], point) > distanceSquared) {
+                output[insertAt] = output[insertAt - 1];
+                insertAt--;
+              }
+
+              output[insertAt] = item;
+              numFound = std::min(numFound + 1, output.size());
+            }
+          }
+        }
+      }
+    }
+
+    return numFound;
+  }
+
+  size_t SpatialGrid::size() const {
+    return itemMins.size();
+  }
+
+  float SpatialGrid::getDistanceSquared(const uint32_t item, const Structs::Vector& point) const {
+    const auto& itemMin = itemMins[item];
+    const auto& itemMax = itemMaxs[item];
+
+    const auto dx = std::max({itemMin.x - point.x, 0.f, point.x - itemMax.x});
+    const auto dy = std::max({itemMin.y - point.y, 0.f, point.y - itemMax.y});
+    const auto dz = std::max({itemMin.z - point.z, 0.f, point.z - itemMax.z});
+
+    return dx * dx + dy * dy + dz * dz;
+  }
+
+  std::array<int32_t, 3> SpatialGrid::getCellCoordinate(const std::array<float, 3>& position) const {
+    std::array<int32_t, 3> coordinate{};
+
+    for (size_t axis = 0; axis < 3; axis++) {
+      const auto cell = std::floor((position[axis] - boundsMin[axis]) / cellSize);
+      coordinate[axis] = static_cast<int32_t>(std::clamp(cell, 0.f, static_cast<float>(dimensions[axis] - 1)));
+    }
+
+    return coordinate;
+  }
+
+  size_t SpatialGrid::getCellIndex(const std::array<int32_t, 3>& coordinate) const {
+    return (static_cast<size_t>(coordinate[2]) * dimensions[1] + coordinate[1]) * dimensions[0] + coordinate[0];
+  }
+}
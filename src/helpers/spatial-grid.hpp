@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../structs/common.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace BspParser::Internal {
+  /**
+   * Uniform grid over axis-aligned item bounds, stored as a compressed cell to item list.
+   * Builds in linear time and answers box and nearest queries without allocating.
+   */
+  class SpatialGrid {
+  public:
+    SpatialGrid() = default;
+
+    /**
+     * @param mins Minimum bounds of each item. Points use the same value for both bounds.
+     * @param maxs Maximum bounds of each item. Must be the same length as mins.
+     * @param requestedCellSize Edge length of a cell, or zero to pick one from the item density.
+     * The cell size may grow to keep the number of cells proportional to the number of items.
+     */
+    SpatialGrid(
+      std::span<const Structs::Vector> mins, std::span<const Structs::Vector> maxs, float requestedCellSize = 0.f
+    );
+
+    /**
+     * Calls callback once with the index of each item whose bounds overlap the box.
+     */
+    template <typename Callback>
+    void queryBox(const Structs::Vector& min, const Structs::Vector& max, Callback&& callback) const {
+      if (itemMins.empty()) {
+        return;
+      }
+
+      const auto queryMin = std::array{min.x, min.y, min.z};
+      const auto queryMax = std::array{max.x, max.y, max.z};
+
+      for (size_t axis = 0; axis < 3; axis++) {
+        if (queryMax[axis] < boundsMin[axis] || queryMin[axis] > boundsMax[axis]) {
+          return;
+        }
+      }
+
+      const auto firstCell = getCellCoordinate(queryMin);
+      const auto lastCell = getCellCoordinate(queryMax);
+
+      for (int32_t z = firstCell[2]; z <= lastCell[2]; z++) {
+        for (int32_t y = firstCell[1]; y <= lastCell[1]; y++) {
+          for (int32_t x = firstCell[0]; x <= lastCell[0]; x++) {
+            const auto cell = getCellIndex({x, y, z});
+
+            for (auto itemIndex = cellStarts[cell]; itemIndex < cellStarts[cell + 1]; itemIndex++) {
+              const auto item = cellItems[itemIndex];
+              const auto& itemMin = itemMins[item];
+              const auto& itemMax = itemMaxs[item];
+
+              // Items spanning several cells are only reported from the first cell shared with the query
+              const auto itemFirstCell = getCellCoordinate(std::array{itemMin.x, itemMin.y, itemMin.z});
+              if (x != std::max(itemFirstCell[0], firstCell[0]) || y != std::max(itemFirstCell[1], firstCell[1]) ||
+                  z != std::max(itemFirstCell[2], firstCell[2])) {
+                continue;
+              }
+
+              if (itemMax.x < min.x || itemMin.x > max.x || itemMax.y < min.y || itemMin.y > max.y ||
+                  itemMax.z < min.z || itemMin.z > max.z) {
+                continue;
+              }
+
+              callback(item);
+            }
+          }
+        }
+      }
+    }
+
+    /**
+     * Finds the items closest to a point, measuring to the nearest point of their bounds.
+     * @param point Point to search from.
+     * @param output Receives item indices sorted from nearest to furthest. Its size is the number of items to find.
+     * @param maxDistance Items further away than this are ignored.
+     * @return Number of indices written.
+     */
+    size_t queryNearest(
+      const Structs::Vector& point, std::span<uint32_t> output, float maxDistance = std::numeric_limits<float>::max()
+    ) const;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] float getDistanceSquared(uint32_t item, const Structs::Vector& point) const;
+
+  private:
+    std::vector<Structs::Vector> itemMins;
+    std::vector<Structs::Vector> itemMaxs;
+
+    std::array<float, 3> boundsMin{};
+    std::array<float, 3> boundsMax{};
+    std::array<int32_t, 3> dimensions{};
+    float cellSize = 1.f;
+
+    std::vector<uint32_t> cellStarts;
+    std::vector<uint32_t> cellItems;
+
+    [[nodiscard]] std::array<int32_t, 3> getCellCoordinate(const std::array<float, 3>& position) const;
+    [[nodiscard]] size_t getCellIndex(const std::array<int32_t, 3>& coordinate) const;
+  };
+}
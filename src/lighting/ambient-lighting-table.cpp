@@ -0,0 +1,226 @@
+#include "ambient-lighting-table.hpp"
+#include "../accessors/leaf-accessors.hpp"
+#include "colour-decoding.hpp"
+#include <limits>
+#include <stdexcept>
+
+namespace BspParser {
+  namespace {
+    constexpr size_t CHUNK_SIZE = 64;
+
+    template <class Leaf>
+    std::pair<Structs::Vector, Structs::Vector> getLeafBounds(const Leaf& leaf) {
+      return {
+        Structs::Vector{
+          .x = static_cast<float>(leaf.mins[0]),
+          .y = static_cast<float>(leaf.mins[1]),
+          .z = static_cast<float>(leaf.mins[2]),
+        },
+        Structs::Vector{
+          .x = static_cast<float>(leaf.maxs[0]),
+          .y = static_cast<float>(leaf.maxs[1]),
+          .z = static_cast<float>(leaf.maxs[2]),
+        },
+      };
+    }
+
+    float lerpByte(const float min, const float max, const uint8_t fraction) {
+      return min + (max - min) * (static_cast<float>(fraction) / 255.f);
+    }
+  }
+
+  AmbientLightingTable::AmbientLightingTable(const Bsp& bsp, const bool preferHdr) {
+    const auto leafCount = Accessors::getLeafCount(bsp);
+    leafFirstSamples.resize(leafCount, 0);
+    leafSampleCounts.resize(leafCount, 0);
+
+    const auto useHdr = preferHdr && !bsp.leafAmbientIndicesHdr.empty() && !bsp.leafAmbientLightingHdr.empty();
+    const auto indices = useHdr ? bsp.leafAmbientIndicesHdr : bsp.leafAmbientIndices;
+    const auto samples = useHdr ? bsp.leafAmbientLightingHdr : bsp.leafAmbientLighting;
+    const auto samplesLump = useHdr ? Enums::Lump::LeafAmbientLightingHdr : Enums::Lump::LeafAmbientLighting;
+
+    std::array<float, NUM_CHANNELS> decoded{};
+    const auto appendSample = [&](const Structs::CompressedLightCube& cube, const Structs::Vector& position) {
+      positionsX.push_back(position.x);
+      positionsY.push_back(position.y);
+      positionsZ.push_back(position.z);
+
+      decodeColoursToLinear(cube, decoded);
+      for (size_t channel = 0; channel < NUM_CHANNELS; channel++) {
+        colours[channel].push_back(decoded[channel]);
+      }
+    };
+
+    const auto reserve = [&](const size_t sampleCount) {
+      positionsX.reserve(sampleCount);
+      positionsY.reserve(sampleCount);
+      positionsZ.reserve(sampleCount);
+      for (auto& channel : colours) {
+        channel.reserve(sampleCount);
+      }
+    };
+
+    std::visit(
+      [&](const auto& leaves) {
+        if (!indices.empty() && indices.size() == leaves.size()) {
+          reserve(samples.size());
+
+          for (size_t leafIndex = 0; leafIndex < leaves.size(); leafIndex++) {
+            const auto& index = indices[leafIndex];
+            if (index.firstAmbientSample + index.ambientSampleCount > samples.size()) {
+              throw Errors::OutOfBoundsAccess(
+                samplesLump,
+                std::format(
+                  "Leaf '{}' ambient samples ({} + {}) overrun the ambient lighting lump ({})",
+                  leafIndex,
+                  index.firstAmbientSample,
+                  index.ambientSampleCount,
+                  samples.size()
+                )
+              );
+            }
+
+            const auto [mins, maxs] = getLeafBounds(leaves[leafIndex]);
+            leafFirstSamples[leafIndex] = static_cast<uint32_t>(positionsX.size());
+            leafSampleCounts[leafIndex] = index.ambientSampleCount;
+
+            for (const auto& sample : samples.subspan(index.firstAmbientSample, index.ambientSampleCount)) {
+              appendSample(
+                sample.cube,
+                Structs::Vector{
+                  .x = lerpByte(mins.x, maxs.x, sample.x),
+                  .y = lerpByte(mins.y, maxs.y, sample.y),
+                  .z = lerpByte(mins.z, maxs.z, sample.z),
+                }
+              );
+            }
+          }
+        } else if constexpr (std::is_same_v<std::decay_t<decltype(leaves)>, std::span<const Structs::LeafV0>>) {
+          // Version 0 leaves hold a single cube for the whole leaf, so treat it as a sample at the centre
+          reserve(leaves.size());
+
+          for (size_t leafIndex = 0; leafIndex < leaves.size(); leafIndex++) {
+            const auto [mins, maxs] = getLeafBounds(leaves[leafIndex]);
+            leafFirstSamples[leafIndex] = static_cast<uint32_t>(positionsX.size());
+            leafSampleCounts[leafIndex] = 1;
+
+            appendSample(
+              leaves[leafIndex].ambientLighting,
+              Structs::Vector{
+                .x = lerpByte(mins.x, maxs.x, 128),
+                .y = lerpByte(mins.y, maxs.y, 128),
+                .z = lerpByte(mins.z, maxs.z, 128),
+              }
+            );
+          }
+        }
+      },
+      bsp.leaves
+    );
+  }
+
+  size_t AmbientLightingTable::size() const {
+    return positionsX.size();
+  }
+
+  AmbientCube AmbientLightingTable::sampleLeaf(
+    const size_t leafIndex, const Structs::Vector& point, const AmbientSampling sampling
+  ) const {
+    AmbientCube result{};
+    if (leafIndex >= leafSampleCounts.size() || leafSampleCounts[leafIndex] == 0) {
+      return result;
+    }
+
+    const auto firstSample = leafFirstSamples[leafIndex];
+    const auto sampleCount = leafSampleCounts[leafIndex];
+
+    std::array<float, NUM_CHANNELS> totals{};
+    auto totalWeight = 0.f;
+    auto nearestSample = firstSample;
+    auto nearestDistanceSquared = std::numeric_limits<float>::max();
+
+    // Work in fixed size chunks so the weights stay on the stack and each pass is a straight vectorisable loop
+    std::array<float, CHUNK_SIZE> weights{};
+    for (size_t chunkStart = firstSample; chunkStart < firstSample + sampleCount; chunkStart += CHUNK_SIZE) {
+      const auto chunkSize = std::min(CHUNK_SIZE, firstSample + sampleCount - chunkStart);
+
+      for (size_t i = 0; i < chunkSize; i++) {
+        const auto dx = positionsX[chunkStart + i] - point.x;
+        const auto dy = positionsY[chunkStart + i] - point.y;
+        const auto dz = positionsZ[chunkStart + i] - point.z;
+
+        weights[i] = dx * dx + dy * dy + dz * dz;
+      }
+
+      if (sampling == AmbientSampling::Nearest) {
+        for (size_t i = 0; i < chunkSize; i++) {
+          if (weights[i] < nearestDistanceSquared) {
+            nearestDistanceSquared = weights[i];
+            nearestSample = static_cast<uint32_t>(chunkStart + i);
+          }
+        }
+        continue;
+      }
+
+      for (size_t i = 0; i < chunkSize; i++) {
+        weights[i] = 1.f / (weights[i] + 1.f);
+        totalWeight += weights[i];
+      }
+
+      for (size_t channel = 0; channel < NUM_CHANNELS; channel++) {
+        const auto* const values = colours[channel].data() + chunkStart;
+        auto total = 0.f;
+
+        for (size_t i = 0; i < chunkSize; i++) {
+          total += values[i] * weights[i];
+        }
+
+        totals[channel] += total;
+      }
+    }
+
+    if (sampling == AmbientSampling::Nearest) {
+      for (size_t channel = 0; channel < NUM_CHANNELS; channel++) {
+        totals[channel] = colours[channel][nearestSample];
+      }
+    } else {
+      for (auto& total : totals) {
+        total /= totalWeight;
+      }
+    }
+
+    for (size_t side = 0; side < result.colours.size(); side++) {
+      result.colours[side] = Structs::Vector{
+        .x = totals[side * 3 + 0],
+        .y = totals[side * 3 + 1],
+        .z = totals[side * 3 + 2],
+      };
+    }
+
+    return result;
+  }
+
+  AmbientCube AmbientLightingTable::sampleAmbient(
+    const Bsp& bsp, const Structs::Vector& point, const AmbientSampling sampling
+  ) const {
+    return sampleLeaf(Accessors::findLeaf(bsp, point), point, sampling);
+  }
+
+  void AmbientLightingTable::sampleAmbient(
+    const Bsp& bsp,
+    const std::span<const Structs::Vector> points,
+    const std::span<AmbientCube> output,
+    const AmbientSampling sampling
+  ) const {
+    if (output.size() < points.size()) {
+      throw std::invalid_argument(
+        std::format("Output ({}) is smaller than the number of points ({})", output.size(), points.size())
+      );
+    }
+
+    for (size_t pointIndex = 0; pointIndex < points.size(); pointIndex++) {
+      const auto& point = points[pointIndex];
+      output[pointIndex] = sampleLeaf(Accessors::findLeaf(bsp, point), point, sampling);
+    }
+  }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Linear colours along +X, -X, +Y, -Y, +Z and -Z.
+   */
+  struct AmbientCube {
+    std::array<Structs::Vector, 6> colours;
+  };
+
+  enum class AmbientSampling : uint8_t {
+    /**
+     * Use the sample closest to the point.
+     */
+    Nearest,
+
+    /**
+     * Blend every sample in the leaf weighted by inverse squared distance, as the engine does.
+     */
+    Weighted,
+  };
+
+  /**
+   * Per-leaf ambient cube samples, decoded once to linear floats and stored as a structure of arrays.
+   */
+  struct AmbientLightingTable {
+    static constexpr size_t NUM_CHANNELS = 6 * 3;
+
+    AmbientLightingTable() = default;
+
+    /**
+     * Decodes the ambient lighting lumps, or the ambient cubes embedded in version 0 leaves.
+     * @param bsp BSP instance.
+     * @param preferHdr Whether to use the HDR lumps when available.
+     * @throws Errors::OutOfBoundsAccess A leaf's samples overrun the ambient lighting lump.
+     */
+    explicit AmbientLightingTable(const Bsp& bsp, bool preferHdr = true);
+
+    /**
+     * Range of samples for each leaf.
+     */
+    std::vector<uint32_t> leafFirstSamples;
+    std::vector<uint32_t> leafSampleCounts;
+
+    std::vector<float> positionsX;
+    std::vector<float> positionsY;
+    std::vector<float> positionsZ;
+
+    /**
+     * Linear colour of each sample, indexed by side * 3 + channel then sample.
+     */
+    std::array<std::vector<float>, NUM_CHANNELS> colours;
+
+    [[nodiscard]] size_t size() const;
+
+    /**
+     * Samples ambient lighting within a known leaf.
+     * @param leafIndex Leaf containing the point.
+     * @param point World space position.
+     * @param sampling How to combine the leaf's samples.
+     * @return Ambient cube at the point. Black if the leaf has no samples.
+     */
+    [[nodiscard]] AmbientCube sampleLeaf(
+      size_t leafIndex, const Structs::Vector& point, AmbientSampling sampling = AmbientSampling::Weighted
+    ) const;
+
+    /**
+     * Finds the leaf containing the point and samples its ambient lighting.
+     * @param bsp BSP instance the table was built from.
+     * @param point World space position.
+     * @param sampling How to combine the leaf's samples.
+     * @return Ambient cube at the point. Black if the leaf has no samples.
+     */
+    [[nodiscard]] AmbientCube sampleAmbient(
+      const Bsp& bsp, const Structs::Vector& point, AmbientSampling sampling = AmbientSampling::Weighted
+    ) const;
+
+    /**
+     * Batched sampleAmbient.
+     * @param bsp BSP instance the table was built from.
+     * @param points World space positions.
+     * @param output Receives an ambient cube per point. Must be at least points.size() long.
+     * @param sampling How to combine the leaf's samples.
+     */
+    void sampleAmbient(
+      const Bsp& bsp,
+      std::span<const Structs::Vector> points,
+      std::span<AmbientCube> output,
+      AmbientSampling sampling = AmbientSampling::Weighted
+    ) const;
+  };
+}
@@ -0,0 +1,82 @@
+#include "colour-decoding.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace BspParser {
+  namespace {
+    /**
+     * Builds 2^exponent / 255 directly from the float bit pattern, avoiding a table lookup so the loops vectorise.
+     */
+    float getExponentScale(const int8_t exponent) {
+      constexpr int32_t minNormalExponent = -126;
+      const auto biasedExponent = std::max(static_cast<int32_t>(exponent), minNormalExponent) + 127;
+
+      return std::bit_cast<float>(static_cast<uint32_t>(biasedExponent) << 23u) * (1.f / 255.f);
+    }
+  }
+
+  void decodeColoursToLinear(const std::span<const Structs::ColourRgbExp32> samples, const std::span<float> output) {
+    const auto* const input = samples.data();
+    auto* const result = output.data();
+
+    for (size_t i = 0; i < samples.size(); i++) {
+      const auto scale = getExponentScale(input[i].exponent);
+
+      result[i * 3 + 0] = static_cast<float>(input[i].r) * scale;
+      result[i * 3 + 1] = static_cast<float>(input[i].g) * scale;
+      result[i * 3 + 2] = static_cast<float>(input[i].b) * scale;
+    }
+  }
+
+  void decodeColoursToRgba8(
+    const std::span<const Structs::ColourRgbExp32> samples, const std::span<uint8_t> output, const float scale
+  ) {
+    const auto* const input = samples.data();
+    auto* const result = output.data();
+
+    for (size_t i = 0; i < samples.size(); i++) {
+      const auto sampleScale = getExponentScale(input[i].exponent) * scale * 255.f;
+
+      result[i * 4 + 0] = static_cast<uint8_t>(std::min(static_cast<float>(input[i].r) * sampleScale + 0.5f, 255.f));
+      result[i * 4 + 1] = static_cast<uint8_t>(std::min(static_cast<float>(input[i].g) * sampleScale + 0.5f, 255.f));
+      result[i * 4 + 2] = static_cast<uint8_t>(std::min(static_cast<float>(input[i].b) * sampleScale + 0.5f, 255.f));
+      result[i * 4 + 3] = 255;
+    }
+  }
+
+  void decodeColoursToRgb9e5(const std::span<const Structs::ColourRgbExp32> samples, const std::span<uint32_t> output) {
+    // https://registry.khronos.org/OpenGL/extensions/EXT/EXT_texture_shared_exponent.txt
+    constexpr int32_t exponentBias = 15;
+    constexpr int32_t mantissaBits = 9;
+    constexpr float maxValue = 65408.f;
+
+    const auto* const input = samples.data();
+    auto* const result = output.data();
+
+    for (size_t i = 0; i < samples.size(); i++) {
+      const auto scale = getExponentScale(input[i].exponent);
+
+      const auto r = std::min(static_cast<float>(input[i].r) * scale, maxValue);
+      const auto g = std::min(static_cast<float>(input[i].g) * scale, maxValue);
+      const auto b = std::min(static_cast<float>(input[i].b) * scale, maxValue);
+      const auto maxComponent = std::max({r, g, b});
+
+      // floor(log2(maxComponent)) read straight from the float's exponent bits
+      const auto log2 = static_cast<int32_t>((std::bit_cast<uint32_t>(maxComponent) >> 23u) & 0xFFu) - 127;
+      auto sharedExponent = std::max(-exponentBias - 1, log2) + 1 + exponentBias;
+
+      auto denominator = std::bit_cast<float>(static_cast<uint32_t>(sharedExponent - exponentBias - mantissaBits + 127)
+                                              << 23u);
+      if (static_cast<int32_t>(maxComponent / denominator + 0.5f) == 1 << mantissaBits) {
+        denominator *= 2.f;
+        sharedExponent++;
+      }
+
+      const auto red = static_cast<uint32_t>(r / denominator + 0.5f);
+      const auto green = static_cast<uint32_t>(g / denominator + 0.5f);
+      const auto blue = static_cast<uint32_t>(b / denominator + 0.5f);
+
+      result[i] = red | green << 9u | blue << 18u | static_cast<uint32_t>(sharedExponent) << 27u;
+    }
+  }
+}
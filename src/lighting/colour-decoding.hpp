@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../structs/common.hpp"
+#include <cstdint>
+#include <span>
+
+namespace BspParser {
+  /**
+   * Decodes samples to linear RGB floats, where 1 is the brightest value representable without overbright.
+   * @param samples Samples to decode.
+   * @param output Receives three floats per sample. Must be at least samples.size() * 3 long.
+   */
+  void decodeColoursToLinear(std::span<const Structs::ColourRgbExp32> samples, std::span<float> output);
+
+  /**
+   * Decodes samples to linear RGBA8, clamping at full intensity. Alpha is always 255.
+   * @param samples Samples to decode.
+   * @param output Receives four bytes per sample. Must be at least samples.size() * 4 long.
+   * @param scale Multiplier applied before clamping, e.g. 0.5 to preserve 2x overbright.
+   */
+  void decodeColoursToRgba8(
+    std::span<const Structs::ColourRgbExp32> samples, std::span<uint8_t> output, float scale = 1.f
+  );
+
+  /**
+   * Decodes samples to the shared exponent RGB9E5 format (e.g. GL_RGB9_E5, DXGI_FORMAT_R9G9B9E5_SHAREDEXP),
+   * which preserves HDR range at 32 bits per sample.
+   * @param samples Samples to decode.
+   * @param output Receives one packed value per sample. Must be at least samples.size() long.
+   */
+  void decodeColoursToRgb9e5(std::span<const Structs::ColourRgbExp32> samples, std::span<uint32_t> output);
+}
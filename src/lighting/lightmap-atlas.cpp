@@ -0,0 +1,227 @@
+#include "lightmap-atlas.hpp"
+#include "../accessors/lightmap-accessors.hpp"
+#include "colour-decoding.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace BspParser {
+  namespace {
+    struct SkylineNode {
+      uint32_t x;
+      uint32_t y;
+      uint32_t width;
+    };
+
+    /**
+     * Skyline bottom-left packer. The nodes always cover the full width of the page, ordered by x.
+     */
+    class Skyline {
+    public:
+      Skyline(const uint32_t width, const uint32_t height) : width(width), height(height) {
+        nodes.push_back(SkylineNode{.x = 0, .y = 0, .width = width});
+      }
+
+      std::optional<std::pair<uint32_t, uint32_t>> insert(const uint32_t rectWidth, const uint32_t rectHeight) {
+        auto bestIndex = nodes.size();
+        auto bestX = width;
+        auto bestY = height;
+
+        for (size_t nodeIndex = 0; nodeIndex < nodes.size(); nodeIndex++) {
+          const auto x = nodes[nodeIndex].x;
+          if (x + rectWidth > width) {
+            break;
+          }
+
+          const auto y = getRestingHeight(nodeIndex, rectWidth);
+          if (y + rectHeight <= height && y < bestY) {
+            bestIndex = nodeIndex;
+            bestX = x;
+            bestY = y;
+          }
+        }
+
+        if (bestIndex == nodes.size()) {
+          return std::nullopt;
+        }
+
+        place(bestIndex, bestX, bestY + rectHeight, rectWidth);
+        return std::pair{bestX, bestY};
+      }
+
+    private:
+      uint32_t width;
+      uint32_t height;
+      std::vector<SkylineNode> nodes;
+
+      [[nodiscard]] uint32_t getRestingHeight(size_t nodeIndex, const uint32_t rectWidth) const {
+        const auto right = nodes[nodeIndex].x + rectWidth;
+        uint32_t y = 0;
+
+        for (; nodeIndex < nodes.size() && nodes[nodeIndex].x < right; nodeIndex++) {
+          y = std::max(y, nodes[nodeIndex].y);
+        }
+
+        return y;
+      }
+
+      void place(const size_t nodeIndex, const uint32_t x, const uint32_t y, const uint32_t rectWidth) {
+        const auto node = SkylineNode{.x = x, .y = y, .width = rectWidth};
+        nodes.insert(nodes.begin() + static_cast<ptrdiff_t>(nodeIndex), node);
+
+        // Trim or remove the nodes now covered by the new one
+        const auto right = x + rectWidth;
+        auto next = nodeIndex + 1;
+        while (next < nodes.size() && nodes[next].x < right) {
+          const auto nodeRight = nodes[next].x + nodes[next].width;
+          if (nodeRight <= right) {
+            nodes.erase(nodes.begin() + static_cast<ptrdiff_t>(next));
+            continue;
+          }
+
+          nodes[next].width = nodeRight - right;
+          nodes[next].x = right;
+          break;
+        }
+
+        // Merge runs of equal height so the node count stays proportional to the skyline's complexity
+        for (size_t i = nodeIndex > 0 ? nodeIndex - 1 : 0; i + 1 < nodes.size() && i <= nodeIndex + 1;) {
+          if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].width += nodes[i + 1].width;
+            nodes.erase(nodes.begin() + static_cast<ptrdiff_t>(i + 1));
+          } else {
+            i++;
+          }
+        }
+      }
+    };
+  }
+
+  LightmapAtlas::LightmapAtlas(const Bsp& bsp, const uint32_t pageWidth, const uint32_t pageHeight) :
+    pageWidth(pageWidth), pageHeight(pageHeight) {
+    faceRects.resize(bsp.faces.size());
+
+    std::vector<uint32_t> faceOrder;
+    faceOrder.reserve(bsp.faces.size());
+
+    for (uint32_t faceIndex = 0; faceIndex < bsp.faces.size(); faceIndex++) {
+      const auto& face = bsp.faces[faceIndex];
+      if (face.lightOffset < 0 || face.texInfo < 0 || face.texInfo >= bsp.textureInfos.size()) {
+        continue;
+      }
+
+      const auto& size = face.lightmapTextureSizeInLuxels;
+      if (size[0] < 0 || size[1] < 0) {
+        continue;
+      }
+
+      const auto rect = LightmapAtlasRect{
+        .lightmapWidth = static_cast<uint32_t>(size[0]) + 1,
+        .lightmapHeight = static_cast<uint32_t>(size[1]) + 1,
+        .lightmapCount = static_cast<uint32_t>(Accessors::getLightmapsPerStyle(bsp.textureInfos[face.texInfo])),
+      };
+
+      if (rect.lightmapWidth * rect.lightmapCount > pageWidth || rect.lightmapHeight > pageHeight) {
+        throw std::invalid_argument(
+          std::format(
+            "Lightmap of face '{}' ({}x{}) does not fit in a {}x{} page",
+            faceIndex,
+            rect.lightmapWidth * rect.lightmapCount,
+            rect.lightmapHeight,
+            pageWidth,
+            pageHeight
+          )
+        );
+      }
+
+      faceRects[faceIndex] = rect;
+      faceOrder.push_back(faceIndex);
+    }
+
+    // Tallest first keeps the skyline flat, which is where bottom-left packing does best
+    std::ranges::stable_sort(faceOrder, [this](const uint32_t a, const uint32_t b) {
+      const auto& rectA = faceRects[a].value();
+      const auto& rectB = faceRects[b].value();
+
+      if (rectA.lightmapHeight != rectB.lightmapHeight) {
+        return rectA.lightmapHeight > rectB.lightmapHeight;
+      }
+
+      return rectA.lightmapWidth * rectA.lightmapCount > rectB.lightmapWidth * rectB.lightmapCount;
+    });
+
+    std::vector<Skyline> pages;
+    for (const auto faceIndex : faceOrder) {
+      auto& rect = faceRects[faceIndex].value();
+      const auto rectWidth = rect.lightmapWidth * rect.lightmapCount;
+
+      std::optional<std::pair<uint32_t, uint32_t>> position;
+      for (size_t page = 0; page < pages.size() && !position.has_value(); page++) {
+        position = pages[page].insert(rectWidth, rect.lightmapHeight);
+        rect.page = static_cast<uint32_t>(page);
+      }
+
+      if (!position.has_value()) {
+        rect.page = static_cast<uint32_t>(pages.size());
+        position = pages.emplace_back(pageWidth, pageHeight).insert(rectWidth, rect.lightmapHeight);
+      }
+
+      rect.x = position->first;
+      rect.y = position->second;
+    }
+
+    pageCount = pages.size();
+  }
+
+  Structs::Vector2 LightmapAtlas::getPageUv(
+    const LightmapAtlasRect& rect, const Structs::Vector2& lightmapUv, const uint32_t lightmapIndex
+  ) const {
+    const auto x = static_cast<float>(rect.x + rect.lightmapWidth * lightmapIndex);
+    const auto y = static_cast<float>(rect.y);
+
+    return Structs::Vector2{
+      .u = (x + lightmapUv.u * static_cast<float>(rect.lightmapWidth)) / static_cast<float>(pageWidth),
+      .v = (y + lightmapUv.v * static_cast<float>(rect.lightmapHeight)) / static_cast<float>(pageHeight),
+    };
+  }
+
+  void LightmapAtlas::writePageLinear(
+    const Bsp& bsp, const size_t page, const std::span<float> output, const size_t styleIndex, const bool preferHdr
+  ) const {
+    constexpr size_t channels = 3;
+
+    if (output.size() < static_cast<size_t>(pageWidth) * pageHeight * channels) {
+      throw std::invalid_argument(
+        std::format("Output ({}) is smaller than a {}x{} RGB page", output.size(), pageWidth, pageHeight)
+      );
+    }
+
+    std::vector<float> decoded;
+
+    for (size_t faceIndex = 0; faceIndex < faceRects.size(); faceIndex++) {
+      const auto& rect = faceRects[faceIndex];
+      if (!rect.has_value() || rect->page != page) {
+        continue;
+      }
+
+      const auto samples = Accessors::getFaceLightmapSamples(bsp, faceIndex, styleIndex, preferHdr);
+      if (samples.empty()) {
+        continue;
+      }
+
+      decoded.resize(samples.size() * channels);
+      decodeColoursToLinear(samples, decoded);
+
+      // Samples hold each lightmap in turn, whereas the page holds them side by side
+      const auto rowLength = rect->lightmapWidth * channels;
+      for (size_t lightmap = 0; lightmap < rect->lightmapCount; lightmap++) {
+        for (size_t row = 0; row < rect->lightmapHeight; row++) {
+          const auto source = (lightmap * rect->lightmapHeight + row) * rowLength;
+          const auto destination =
+            ((rect->y + row) * pageWidth + rect->x + lightmap * rect->lightmapWidth) * channels;
+
+          std::copy_n(decoded.begin() + source, rowLength, output.begin() + destination);
+        }
+      }
+    }
+  }
+}
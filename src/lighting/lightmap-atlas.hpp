@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Location of a face's lightmaps within an atlas page, in luxels.
+   * Bump-lit faces store their lightmaps side by side, so the rectangle is lightmapWidth * lightmapCount wide.
+   */
+  struct LightmapAtlasRect {
+    uint32_t page = 0;
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t lightmapWidth = 0;
+    uint32_t lightmapHeight = 0;
+    uint32_t lightmapCount = 1;
+  };
+
+  /**
+   * Packs the lightmap of every lit face into fixed size pages with a skyline bottom-left packer,
+   * so baked lighting can be drawn with one texture per page.
+   *
+   * @note Rectangles hold a single light style. Faces with multiple styles should have them composited into the page.
+   */
+  struct LightmapAtlas {
+    /**
+     * @param bsp BSP instance.
+     * @param pageWidth Width of each page in luxels.
+     * @param pageHeight Height of each page in luxels.
+     * @throws std::invalid_argument A face's lightmap does not fit in an empty page.
+     */
+    explicit LightmapAtlas(const Bsp& bsp, uint32_t pageWidth = 1024, uint32_t pageHeight = 1024);
+
+    uint32_t pageWidth;
+    uint32_t pageHeight;
+    size_t pageCount = 0;
+
+    /**
+     * Rectangle for each face, indexed the same as Bsp::faces. Empty for faces without a lightmap.
+     */
+    std::vector<std::optional<LightmapAtlasRect>> faceRects;
+
+    /**
+     * Remaps a vertex's face local lightmap UV into its page.
+     * @param rect Rectangle of the face the vertex belongs to.
+     * @param lightmapUv Vertex::lightmapUv.
+     * @param lightmapIndex Which of a bump-lit face's lightmaps to address (0 for the flat lightmap).
+     * @return Normalised coordinates within the rectangle's page.
+     */
+    [[nodiscard]] Structs::Vector2 getPageUv(
+      const LightmapAtlasRect& rect, const Structs::Vector2& lightmapUv, uint32_t lightmapIndex = 0
+    ) const;
+
+    /**
+     * Decodes one light style of every face on a page into a linear RGB float image.
+     * @param bsp BSP instance the atlas was built from.
+     * @param page Index of the page to write.
+     * @param output Receives pageWidth * pageHeight * 3 floats, row-major. Luxels not covered by a face are untouched.
+     * @param styleIndex Which of each face's light styles to write. Faces without the style are skipped.
+     * @param preferHdr Whether to use the HDR lumps when available.
+     */
+    void writePageLinear(
+      const Bsp& bsp, size_t page, std::span<float> output, size_t styleIndex = 0, bool preferHdr = true
+    ) const;
+  };
+}
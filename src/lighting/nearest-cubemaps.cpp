@@ -0,0 +1,39 @@
+#include "nearest-cubemaps.hpp"
+#include "../helpers/parallel-for.hpp"
+#include "../helpers/spatial-grid.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace BspParser::Internal {
+  void findNearestCubemaps(
+    const std::span<const Structs::CubemapSample> cubemaps,
+    const std::span<const Structs::Vector> positions,
+    const std::span<int32_t> output
+  ) {
+    if (cubemaps.empty()) {
+      std::fill_n(output.begin(), positions.size(), -1);
+      return;
+    }
+
+    std::vector<Structs::Vector> origins;
+    origins.reserve(cubemaps.size());
+    for (const auto& cubemap : cubemaps) {
+      origins.push_back(
+        Structs::Vector{
+          .x = static_cast<float>(cubemap.origin[0]),
+          .y = static_cast<float>(cubemap.origin[1]),
+          .z = static_cast<float>(cubemap.origin[2]),
+        }
+      );
+    }
+
+    const SpatialGrid grid(origins, origins);
+
+    parallelFor(positions.size(), [&](const size_t positionIndex) {
+      uint32_t nearest = 0;
+      grid.queryNearest(positions[positionIndex], std::span(&nearest, 1));
+
+      output[positionIndex] = static_cast<int32_t>(nearest);
+    });
+  }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../structs/common.hpp"
+#include "../structs/lighting.hpp"
+#include <cstdint>
+#include <span>
+
+namespace BspParser::Internal {
+  /**
+   * Finds the cubemap nearest to each position, spreading the queries across threads.
+   * @param cubemaps Cubemap samples to search.
+   * @param positions Positions to find cubemaps for.
+   * @param output Receives the cubemap index for each position, or -1 if there are no cubemaps.
+   */
+  void findNearestCubemaps(
+    std::span<const Structs::CubemapSample> cubemaps,
+    std::span<const Structs::Vector> positions,
+    std::span<int32_t> output
+  );
+}
@@ -0,0 +1,247 @@
+#include "world-light-index.hpp"
+#include "../helpers/vector-maths.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace BspParser {
+  using namespace Internal;
+
+  namespace {
+    constexpr size_t POINT_RUN_SIZE = 64;
+
+    Structs::WorldLightV1 upgradeWorldLight(const Structs::WorldLightV0& light) {
+      return Structs::WorldLightV1{
+        .origin = light.origin,
+        .intensity = light.intensity,
+        .normal = light.normal,
+        .shadowCastOffset = Structs::Vector{},
+        .cluster = light.cluster,
+        .type = light.type,
+        .style = light.style,
+        .stopDot = light.stopDot,
+        .stopDot2 = light.stopDot2,
+        .exponent = light.exponent,
+        .radius = light.radius,
+        .constantAttenuation = light.constantAttenuation,
+        .linearAttenuation = light.linearAttenuation,
+        .quadraticAttenuation = light.quadraticAttenuation,
+        .flags = light.flags,
+        .texInfo = light.texInfo,
+        .owner = light.owner,
+      };
+    }
+
+    Structs::WorldLightV1 upgradeWorldLight(const Structs::WorldLightV1& light) {
+      return light;
+    }
+
+    float calculateInfluenceRadius(const Structs::WorldLightV1& light, const float minIntensity) {
+      constexpr auto infinity = std::numeric_limits<float>::infinity();
+
+      if (light.type == Enums::EmitType::Skylight || light.type == Enums::EmitType::SkyAmbient) {
+        return infinity;
+      }
+
+      if (light.radius > 0.f) {
+        return light.radius;
+      }
+
+      // Quake lights fall off linearly to zero at their linear attenuation distance
+      if (light.type == Enums::EmitType::QuakeLight) {
+        return light.linearAttenuation > 0.f ? light.linearAttenuation : infinity;
+      }
+
+      // Solve intensity / (c + b * d + a * d^2) = minIntensity for d
+      const auto intensity = std::max({light.intensity.x, light.intensity.y, light.intensity.z});
+      const auto a = light.quadraticAttenuation;
+      const auto b = light.linearAttenuation;
+      const auto c = light.constantAttenuation - intensity / minIntensity;
+
+      if (a > 0.f) {
+        const auto discriminant = b * b - 4.f * a * c;
+        return discriminant <= 0.f ? 0.f : std::max((-b + std::sqrt(discriminant)) / (2.f * a), 0.f);
+      }
+
+      if (b > 0.f) {
+        return std::max(-c / b, 0.f);
+      }
+
+      return infinity;
+    }
+  }
+
+  WorldLightIndex::WorldLightIndex(const Bsp& bsp, const bool preferHdr) {
+    const auto hasHdrLights = std::visit([](const auto& hdrLights) { return !hdrLights.empty(); }, bsp.worldLightsHdr);
+    const auto useHdr = preferHdr && hasHdrLights;
+    const auto minIntensity = useHdr ? MIN_LIGHT_INTENSITY_HDR : MIN_LIGHT_INTENSITY;
+
+    std::visit(
+      [this](const auto& worldLights) {
+        lights.reserve(worldLights.size());
+        for (const auto& light : worldLights) {
+          lights.push_back(upgradeWorldLight(light));
+        }
+      },
+      useHdr ? bsp.worldLightsHdr : bsp.worldLights
+    );
+
+    std::vector<Structs::Vector> mins;
+    std::vector<Structs::Vector> maxs;
+    auto maxRadius = 0.f;
+
+    for (uint32_t lightIndex = 0; lightIndex < lights.size(); lightIndex++) {
+      const auto& light = lights[lightIndex];
+      const auto radius = calculateInfluenceRadius(light, minIntensity);
+
+      influenceRadii.push_back(radius);
+      influenceRadiiSquared.push_back(radius * radius);
+      originsX.push_back(light.origin.x);
+      originsY.push_back(light.origin.y);
+      originsZ.push_back(light.origin.z);
+
+      if (std::isinf(radius)) {
+        globalLights.push_back(lightIndex);
+        continue;
+      }
+
+      const auto extent = Structs::Vector{radius, radius, radius};
+      localLights.push_back(lightIndex);
+      mins.push_back(sub(light.origin, extent));
+      maxs.push_back(add(light.origin, extent));
+      maxRadius = std::max(maxRadius, radius);
+    }
+
+    grid = SpatialGrid(mins, maxs, maxRadius);
+  }
+
+  std::span<const Structs::WorldLightV1> WorldLightIndex::getLights() const {
+    return lights;
+  }
+
+  float WorldLightIndex::getInfluenceRadius(const uint32_t lightIndex) const {
+    return influenceRadii.at(lightIndex);
+  }
+
+  size_t WorldLightIndex::queryPoint(const Structs::Vector& point, const std::span<uint32_t> output) const {
+    size_t numFound = 0;
+    const auto write = [&](const uint32_t lightIndex) {
+      if (numFound < output.size()) {
+        output[numFound] = lightIndex;
+      }
+      numFound++;
+    };
+
+    grid.queryBox(point, point, [&](const uint32_t item) {
+      const auto lightIndex = localLights[item];
+      if (affectsPoint(lightIndex, point)) {
+        write(lightIndex);
+      }
+    });
+
+    for (const auto lightIndex : globalLights) {
+      write(lightIndex);
+    }
+
+    return numFound;
+  }
+
+  size_t WorldLightIndex::queryBox(
+    const Structs::Vector& min, const Structs::Vector& max, const std::span<uint32_t> output
+  ) const {
+    size_t numFound = 0;
+    const auto write = [&](const uint32_t lightIndex) {
+      if (numFound < output.size()) {
+        output[numFound] = lightIndex;
+      }
+      numFound++;
+    };
+
+    grid.queryBox(min, max, [&](const uint32_t item) {
+      const auto lightIndex = localLights[item];
+      const auto& origin = lights[lightIndex].origin;
+
+      // Distance from the light to the closest point of the box
+      const auto dx = origin.x - std::clamp(origin.x, min.x, max.x);
+      const auto dy = origin.y - std::clamp(origin.y, min.y, max.y);
+      const auto dz = origin.z - std::clamp(origin.z, min.z, max.z);
+
+      if (dx * dx + dy * dy + dz * dz <= influenceRadiiSquared[lightIndex]) {
+        write(lightIndex);
+      }
+    });
+
+    for (const auto lightIndex : globalLights) {
+      write(lightIndex);
+    }
+
+    return numFound;
+  }
+
+  void WorldLightIndex::queryPoints(
+    const std::span<const Structs::Vector> points,
+    std::vector<uint32_t>& pointOffsets,
+    std::vector<uint32_t>& lightIndices
+  ) const {
+    pointOffsets.clear();
+    lightIndices.clear();
+    pointOffsets.reserve(points.size() + 1);
+
+    std::vector<uint32_t> candidates;
+
+    for (size_t runStart = 0; runStart < points.size(); runStart += POINT_RUN_SIZE) {
+      const auto run = points.subspan(runStart, std::min(POINT_RUN_SIZE, points.size() - runStart));
+
+      auto runMin = run.front();
+      auto runMax = run.front();
+      for (const auto& point : run) {
+        runMin = Structs::Vector{std::min(runMin.x, point.x), std::min(runMin.y, point.y), std::min(runMin.z, point.z)};
+        runMax = Structs::Vector{std::max(runMax.x, point.x), std::max(runMax.y, point.y), std::max(runMax.z, point.z)};
+      }
+
+      candidates.clear();
+      grid.queryBox(runMin, runMax, [&](const uint32_t item) { candidates.push_back(localLights[item]); });
+
+      for (const auto& point : run) {
+        pointOffsets.push_back(static_cast<uint32_t>(lightIndices.size()));
+
+        for (const auto lightIndex : candidates) {
+          if (affectsPoint(lightIndex, point)) {
+            lightIndices.push_back(lightIndex);
+          }
+        }
+
+        lightIndices.insert(lightIndices.end(), globalLights.begin(), globalLights.end());
+      }
+    }
+
+    pointOffsets.push_back(static_cast<uint32_t>(lightIndices.size()));
+  }
+
+  bool WorldLightIndex::affectsPoint(const uint32_t lightIndex, const Structs::Vector& point) const {
+    const auto dx = point.x - originsX[lightIndex];
+    const auto dy = point.y - originsY[lightIndex];
+    const auto dz = point.z - originsZ[lightIndex];
+    const auto distanceSquared = dx * dx + dy * dy + dz * dz;
+
+    if (distanceSquared > influenceRadiiSquared[lightIndex]) {
+      return false;
+    }
+
+    const auto& light = lights[lightIndex];
+    const auto alongNormal = dx * light.normal.x + dy * light.normal.y + dz * light.normal.z;
+
+    switch (light.type) {
+      case Enums::EmitType::Surface:
+        return alongNormal > 0.f;
+      case Enums::EmitType::Spotlight:
+        // Compare cosines without normalising: dot(d, n) >= stopDot2 * |d|
+        if (light.stopDot2 >= 0.f) {
+          return alongNormal >= 0.f && alongNormal * alongNormal >= light.stopDot2 * light.stopDot2 * distanceSquared;
+        }
+        return alongNormal >= 0.f || alongNormal * alongNormal <= light.stopDot2 * light.stopDot2 * distanceSquared;
+      default:
+        return true;
+    }
+  }
+}
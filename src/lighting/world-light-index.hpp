@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include "../helpers/spatial-grid.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Spatial index over world lights by their influence radius, for finding the lights that affect points or boxes.
+   * Sky lights and lights which never fall off are global and returned by every query.
+   */
+  class WorldLightIndex {
+  public:
+    /**
+     * Intensity below which a light is considered to no longer contribute, used to derive influence radii
+     * for lights without an explicit radius. Matches the engine's cutoffs.
+     */
+    static constexpr float MIN_LIGHT_INTENSITY = 0.03f;
+    static constexpr float MIN_LIGHT_INTENSITY_HDR = 0.015f;
+
+    /**
+     * Builds the index in linear time.
+     * @param bsp BSP instance.
+     * @param preferHdr Whether to use the HDR world lights when available.
+     */
+    explicit WorldLightIndex(const Bsp& bsp, bool preferHdr = true);
+
+    /**
+     * All lights in lump order, upgraded to the latest version. Query results index into this.
+     */
+    [[nodiscard]] std::span<const Structs::WorldLightV1> getLights() const;
+
+    /**
+     * Distance past which the light no longer contributes, or infinity for global lights.
+     */
+    [[nodiscard]] float getInfluenceRadius(uint32_t lightIndex) const;
+
+    /**
+     * Finds lights affecting a point, taking spotlight cones into account.
+     * @param output Receives light indices in no particular order.
+     * @return Total number of matching lights, which may exceed the number written if output is too small.
+     */
+    size_t queryPoint(const Structs::Vector& point, std::span<uint32_t> output) const;
+
+    /**
+     * Finds lights whose influence sphere overlaps an axis-aligned box.
+     * @param output Receives light indices in no particular order.
+     * @return Total number of matching lights, which may exceed the number written if output is too small.
+     */
+    size_t queryBox(const Structs::Vector& min, const Structs::Vector& max, std::span<uint32_t> output) const;
+
+    /**
+     * Finds lights affecting each of many points, such as the vertices of a mesh.
+     * Points are processed in runs with candidate lights gathered once per run,
+     * so spatially coherent input such as a mesh's vertices is fastest.
+     * @param points Points to query.
+     * @param pointOffsets Cleared and filled with points.size() + 1 offsets into lightIndices.
+     * Point i is affected by lightIndices[pointOffsets[i]] up to lightIndices[pointOffsets[i + 1]].
+     * @param lightIndices Cleared and filled with the light indices for every point.
+     */
+    void queryPoints(
+      std::span<const Structs::Vector> points, std::vector<uint32_t>& pointOffsets, std::vector<uint32_t>& lightIndices
+    ) const;
+
+  private:
+    std::vector<Structs::WorldLightV1> lights;
+    std::vector<float> influenceRadii;
+
+    std::vector<float> originsX;
+    std::vector<float> originsY;
+    std::vector<float> originsZ;
+    std::vector<float> influenceRadiiSquared;
+
+    Internal::SpatialGrid grid;
+
+    /**
+     * Light index of each item in the grid.
+     */
+    std::vector<uint32_t> localLights;
+    std::vector<uint32_t> globalLights;
+
+    [[nodiscard]] bool affectsPoint(uint32_t lightIndex, const Structs::Vector& point) const;
+  };
+}
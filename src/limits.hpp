@@ -26,6 +26,7 @@ namespace BspParser::Limits {
   constexpr size_t MAX_MAP_DISP_TRIS = (1 << MAX_MAP_DISP_POWER) * (1 << MAX_MAP_DISP_POWER) * 2;
   constexpr size_t MAX_DISPVERTS = NUM_DISP_POWER_VERTS(MAX_MAP_DISP_POWER);
   constexpr size_t MAX_DISPTRIS = NUM_DISP_POWER_TRIS(MAX_MAP_DISP_POWER);
+  constexpr size_t MAX_MAP_DISP_TRIANGLES = MAX_MAP_DISPINFO * MAX_DISPTRIS;
   constexpr size_t MAX_MAP_AREAS = 256;
   constexpr size_t MAX_MAP_AREA_BYTES = MAX_MAP_AREAS / 8;
   constexpr size_t MAX_MAP_AREAPORTALS = 1024;
@@ -33,6 +34,7 @@ namespace BspParser::Limits {
   constexpr size_t MAX_MAP_NODES = 65536;
   constexpr size_t MAX_MAP_BRUSHSIDES = 65536;
   constexpr size_t MAX_MAP_LEAFS = 65536;
+  constexpr size_t MAX_MAP_LEAF_AMBIENT_SAMPLES = 0x1000000;
   constexpr size_t MAX_MAP_VERTS = 65536;
   constexpr size_t MAX_MAP_VERTNORMALS = 256000;
   constexpr size_t MAX_MAP_VERTNORMALINDICES = 256000;
@@ -58,6 +60,16 @@ namespace BspParser::Limits {
   constexpr size_t MAX_MAP_PRIMVERTS = 65536;
   constexpr size_t MAX_MAP_PRIMINDICES = 65536;
 
+  /**
+   * Max # of light styles per face.
+   */
+  constexpr size_t MAX_LIGHTMAPS = 4;
+
+  /**
+   * # of extra lightmaps stored per light style on bump-lit faces.
+   */
+  constexpr size_t NUM_BUMP_VECTS = 3;
+
   constexpr uint8_t DETAIL_NAME_LENGTH = 128;
   constexpr uint8_t STATIC_PROP_NAME_LENGTH = 128;
 
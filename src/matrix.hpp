@@ -0,0 +1,14 @@
+#pragma once
+
+#include "structs/common.hpp"
+#include <array>
+
+namespace BspParser {
+  /**
+   * Row-major affine transform, matching the layout of the Source engine's matrix3x4_t.
+   * The rotation is stored in the upper 3x3 and the translation in the w component of each row.
+   */
+  struct Matrix3x4 {
+    std::array<Structs::Vector4, 3> rows;
+  };
+}
@@ -0,0 +1,461 @@
+#include "occlusion-buffer.hpp"
+#include "../enums/occlusion.hpp"
+#include "../helpers/get-vertex-position.hpp"
+#include "../helpers/parallel-for.hpp"
+#include "../helpers/vector-maths.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+
+namespace BspParser {
+  using namespace Internal;
+
+  namespace {
+    struct Bounds {
+      Structs::Vector min{
+        std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()
+      };
+      Structs::Vector max{
+        std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()
+      };
+
+      void add(const Structs::Vector& point) {
+        min = Structs::Vector{std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z)};
+        max = Structs::Vector{std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z)};
+      }
+    };
+
+    float edgeFunction(const float ax, const float ay, const float bx, const float by, const float px, const float py) {
+      return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+    }
+
+    size_t countVisible(const std::span<const uint8_t> visible) {
+      return static_cast<size_t>(std::count(visible.begin(), visible.end(), uint8_t{1}));
+    }
+
+    template <class OccluderData>
+    void rasteriseOccluderData(
+      const Bsp& bsp, const std::span<const OccluderData> occluders, OcclusionBuffer& buffer
+    ) {
+      std::vector<Structs::Vector> polygon;
+
+      for (const auto& occluder : occluders) {
+        if ((occluder.flags & static_cast<int32_t>(Enums::OccluderFlag::Inactive)) != 0) {
+          continue;
+        }
+
+        if (occluder.firstPoly < 0 || occluder.polyCount < 0 ||
+            occluder.firstPoly + occluder.polyCount > bsp.occluderPolygons.size()) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::Occlusion,
+            std::format(
+              "Occluder's firstPoly + polyCount ({} + {}) is out of bounds of its polygons",
+              occluder.firstPoly,
+              occluder.polyCount
+            )
+          );
+        }
+
+        for (const auto& occluderPolygon : bsp.occluderPolygons.subspan(occluder.firstPoly, occluder.polyCount)) {
+          if (occluderPolygon.firstVertexIndex < 0 || occluderPolygon.vertexCount < 0 ||
+              occluderPolygon.firstVertexIndex + occluderPolygon.vertexCount > bsp.occluderVertexIndices.size()) {
+            throw Errors::OutOfBoundsAccess(
+              Enums::Lump::Occlusion,
+              std::format(
+                "Occluder polygon's firstVertexIndex + vertexCount ({} + {}) is out of bounds of its vertex indices",
+                occluderPolygon.firstVertexIndex,
+                occluderPolygon.vertexCount
+              )
+            );
+          }
+
+          polygon.clear();
+          for (const auto vertexIndex :
+               bsp.occluderVertexIndices.subspan(occluderPolygon.firstVertexIndex, occluderPolygon.vertexCount)) {
+            if (vertexIndex < 0 || vertexIndex >= bsp.vertices.size()) {
+              throw Errors::OutOfBoundsAccess(
+                Enums::Lump::Occlusion,
+                std::format("Occluder vertex index '{}' is out of bounds of the vertex lump", vertexIndex)
+              );
+            }
+
+            polygon.push_back(bsp.vertices[vertexIndex]);
+          }
+
+          buffer.rasterisePolygon(polygon);
+        }
+      }
+    }
+  }
+
+  OcclusionBuffer::OcclusionBuffer(const size_t width, const size_t height) :
+    width(width), height(height), tilesX(width / TILE_SIZE), tilesY(height / TILE_SIZE) {
+    if (width == 0 || height == 0 || width % TILE_SIZE != 0 || height % TILE_SIZE != 0) {
+      throw std::invalid_argument(
+        std::format("Occlusion buffer dimensions ({}x{}) must be non-zero multiples of {}", width, height, TILE_SIZE)
+      );
+    }
+
+    inverseDepths.resize(width * height);
+    tileInverseDepths.resize(tilesX * tilesY);
+    setCamera(OcclusionCamera{});
+  }
+
+  void OcclusionBuffer::setCamera(const OcclusionCamera& camera) {
+    constexpr auto degreesToRadians = std::numbers::pi_v<float> / 180.f;
+
+    position = camera.position;
+    forward = normalise(camera.forward);
+    right = normalise(cross(forward, camera.up));
+    up = cross(right, forward);
+    nearDistance = camera.nearDistance;
+
+    xScale = 1.f / std::tan(camera.horizontalFovDegrees * degreesToRadians * 0.5f);
+    yScale = xScale * static_cast<float>(width) / static_cast<float>(height);
+
+    std::ranges::fill(inverseDepths, 0.f);
+    std::ranges::fill(tileInverseDepths, 0.f);
+  }
+
+  void OcclusionBuffer::rasteriseOccluders(const Bsp& bsp) {
+    std::visit([&](const auto& occluders) { rasteriseOccluderData(bsp, occluders, *this); }, bsp.occluders);
+  }
+
+  void OcclusionBuffer::rasterisePolygon(const std::span<const Structs::Vector> polygon) {
+    if (polygon.size() < 3) {
+      return;
+    }
+
+    clipOutput.clear();
+    for (const auto& point : polygon) {
+      clipOutput.push_back(toView(point));
+    }
+
+    // Clip against the near plane so every vertex has a positive depth to project with
+    clipScratch.clear();
+    for (size_t i = 0; i < clipOutput.size(); i++) {
+      const auto& current = clipOutput[i];
+      const auto& next = clipOutput[(i + 1) % clipOutput.size()];
+      const auto currentDistance = current.z - nearDistance;
+      const auto nextDistance = next.z - nearDistance;
+
+      if (currentDistance >= 0.f) {
+        clipScratch.push_back(current);
+      }
+
+      if ((currentDistance >= 0.f) != (nextDistance >= 0.f)) {
+        clipScratch.push_back(lerp(current, next, currentDistance / (currentDistance - nextDistance)));
+      }
+    }
+
+    if (clipScratch.size() < 3) {
+      return;
+    }
+
+    const auto first = project(clipScratch[0]);
+    for (size_t i = 1; i + 1 < clipScratch.size(); i++) {
+      rasteriseTriangle(first, project(clipScratch[i]), project(clipScratch[i + 1]));
+    }
+  }
+
+  bool OcclusionBuffer::isBoxOccluded(const Structs::Vector& min, const Structs::Vector& max) const {
+    auto screenMinX = std::numeric_limits<float>::max();
+    auto screenMinY = std::numeric_limits<float>::max();
+    auto screenMaxX = std::numeric_limits<float>::lowest();
+    auto screenMaxY = std::numeric_limits<float>::lowest();
+    auto nearestInverseDepth = 0.f;
+
+    for (size_t corner = 0; corner < 8; corner++) {
+      const auto viewPoint = toView(
+        Structs::Vector{
+          (corner & 1) != 0 ? max.x : min.x,
+          (corner & 2) != 0 ? max.y : min.y,
+          (corner & 4) != 0 ? max.z : min.z,
+        }
+      );
+
+      if (viewPoint.z < nearDistance) {
+        return false;
+      }
+
+      const auto screen = project(viewPoint);
+      screenMinX = std::min(screenMinX, screen.x);
+      screenMinY = std::min(screenMinY, screen.y);
+      screenMaxX = std::max(screenMaxX, screen.x);
+      screenMaxY = std::max(screenMaxY, screen.y);
+      nearestInverseDepth = std::max(nearestInverseDepth, screen.inverseDepth);
+    }
+
+    const auto widthF = static_cast<float>(width);
+    const auto heightF = static_cast<float>(height);
+    if (screenMaxX <= 0.f || screenMaxY <= 0.f || screenMinX >= widthF || screenMinY >= heightF) {
+      return false;
+    }
+
+    const auto x0 = static_cast<size_t>(std::max(std::floor(screenMinX), 0.f));
+    const auto y0 = static_cast<size_t>(std::max(std::floor(screenMinY), 0.f));
+    const auto x1 = static_cast<size_t>(std::min(std::ceil(screenMaxX), widthF));
+    const auto y1 = static_cast<size_t>(std::min(std::ceil(screenMaxY), heightF));
+
+    // Tiles whose farthest occluder is still in front of the box need no further work
+    auto needsPixelTest = false;
+    for (auto tileY = y0 / TILE_SIZE; tileY <= (y1 - 1) / TILE_SIZE && !needsPixelTest; tileY++) {
+      for (auto tileX = x0 / TILE_SIZE; tileX <= (x1 - 1) / TILE_SIZE; tileX++) {
+        if (tileInverseDepths[tileY * tilesX + tileX] <= nearestInverseDepth) {
+          needsPixelTest = true;
+          break;
+        }
+      }
+    }
+
+    if (!needsPixelTest) {
+      return true;
+    }
+
+    for (auto y = y0; y < y1; y++) {
+      const auto* row = &inverseDepths[y * width];
+      auto rowOccluded = true;
+
+      for (auto x = x0; x < x1; x++) {
+        rowOccluded &= row[x] > nearestInverseDepth;
+      }
+
+      if (!rowOccluded) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  size_t OcclusionBuffer::testBoxes(
+    const std::span<const Structs::Vector> mins,
+    const std::span<const Structs::Vector> maxs,
+    const std::span<uint8_t> visible
+  ) const {
+    if (mins.size() != maxs.size() || visible.size() < mins.size()) {
+      throw std::invalid_argument("Box minimums, maximums and visibility flags must have matching lengths");
+    }
+
+    parallelFor(
+      mins.size(), [&](const size_t i) { visible[i] = isBoxOccluded(mins[i], maxs[i]) ? 0 : 1; }, 256
+    );
+
+    return countVisible(visible.first(mins.size()));
+  }
+
+  size_t OcclusionBuffer::testFaces(const Bsp& bsp, const std::span<uint8_t> visible) const {
+    if (visible.size() < bsp.faces.size()) {
+      throw std::invalid_argument("Visibility flags must have an entry for every face");
+    }
+
+    parallelFor(
+      bsp.faces.size(),
+      [&](const size_t faceIndex) {
+        const auto& face = bsp.faces[faceIndex];
+        Bounds bounds;
+
+        if (face.dispInfo >= 0) {
+          if (face.dispInfo >= bsp.displacements.size()) {
+            throw Errors::OutOfBoundsAccess(
+              Enums::Lump::Faces,
+              std::format("Face displacement index '{}' is out of bounds of the displacements", face.dispInfo)
+            );
+          }
+
+          for (const auto& vertex : bsp.displacements[face.dispInfo].vertices) {
+            bounds.add(vertex.position);
+          }
+        } else {
+          if (face.firstEdge < 0 || face.firstEdge + face.numEdges > bsp.surfaceEdges.size()) {
+            throw Errors::OutOfBoundsAccess(
+              Enums::Lump::Faces,
+              std::format(
+                "Face's firstEdge + numEdges ({} + {}) is out of bounds of the surf edges lump",
+                face.firstEdge,
+                face.numEdges
+              )
+            );
+          }
+
+          for (const auto surfaceEdge : bsp.surfaceEdges.subspan(face.firstEdge, face.numEdges)) {
+            bounds.add(getVertexPosition(bsp.edges, bsp.vertices, surfaceEdge));
+          }
+        }
+
+        visible[faceIndex] = face.numEdges > 0 && isBoxOccluded(bounds.min, bounds.max) ? 0 : 1;
+      },
+      256
+    );
+
+    return countVisible(visible.first(bsp.faces.size()));
+  }
+
+  size_t OcclusionBuffer::testStaticProps(
+    const StaticPropTable& table,
+    const std::span<const Structs::Vector> modelMins,
+    const std::span<const Structs::Vector> modelMaxs,
+    const std::span<uint8_t> visible
+  ) const {
+    if (modelMins.size() != modelMaxs.size()) {
+      throw std::invalid_argument("Model bounds minimums and maximums must have matching lengths");
+    }
+
+    if (visible.size() < table.size()) {
+      throw std::invalid_argument("Visibility flags must have an entry for every static prop");
+    }
+
+    if (std::ranges::any_of(table.dictionaryIndices, [&](const uint16_t index) { return index >= modelMins.size(); })) {
+      throw std::invalid_argument("Model bounds must have an entry for every static prop dictionary entry");
+    }
+
+    parallelFor(
+      table.size(),
+      [&](const size_t propIndex) {
+        const auto dictionaryIndex = table.dictionaryIndices[propIndex];
+        const auto& localMin = modelMins[dictionaryIndex];
+        const auto& localMax = modelMaxs[dictionaryIndex];
+        const auto localCentre = mul(add(localMin, localMax), 0.5f);
+        const auto localExtents = mul(sub(localMax, localMin), 0.5f);
+
+        // Transforming the centre and summing absolute rotated extents gives the tightest world box around the model box
+        const auto& rows = table.transforms[propIndex].rows;
+        std::array<float, 3> centre{};
+        std::array<float, 3> extents{};
+        for (size_t axis = 0; axis < 3; axis++) {
+          const auto& row = rows[axis];
+          centre[axis] = row.x * localCentre.x + row.y * localCentre.y + row.z * localCentre.z + row.w;
+          extents[axis] = std::abs(row.x) * localExtents.x + std::abs(row.y) * localExtents.y +
+            std::abs(row.z) * localExtents.z;
+        }
+
+        const auto worldMin =
+          Structs::Vector{centre[0] - extents[0], centre[1] - extents[1], centre[2] - extents[2]};
+        const auto worldMax =
+          Structs::Vector{centre[0] + extents[0], centre[1] + extents[1], centre[2] + extents[2]};
+
+        visible[propIndex] = isBoxOccluded(worldMin, worldMax) ? 0 : 1;
+      },
+      256
+    );
+
+    return countVisible(visible.first(table.size()));
+  }
+
+  size_t OcclusionBuffer::getWidth() const {
+    return width;
+  }
+
+  size_t OcclusionBuffer::getHeight() const {
+    return height;
+  }
+
+  std::span<const float> OcclusionBuffer::getInverseDepths() const {
+    return inverseDepths;
+  }
+
+  Structs::Vector OcclusionBuffer::toView(const Structs::Vector& point) const {
+    const auto offset = sub(point, position);
+
+    return Structs::Vector{dot(offset, right), dot(offset, up), dot(offset, forward)};
+  }
+
+  OcclusionBuffer::ScreenVertex OcclusionBuffer::project(const Structs::Vector& viewPoint) const {
+    const auto inverseDepth = 1.f / viewPoint.z;
+
+    return ScreenVertex{
+      .x = (viewPoint.x * inverseDepth * xScale + 1.f) * 0.5f * static_cast<float>(width),
+      .y = (1.f - viewPoint.y * inverseDepth * yScale) * 0.5f * static_cast<float>(height),
+      .inverseDepth = inverseDepth,
+    };
+  }
+
+  void OcclusionBuffer::rasteriseTriangle(ScreenVertex a, ScreenVertex b, ScreenVertex c) {
+    auto area = edgeFunction(a.x, a.y, b.x, b.y, c.x, c.y);
+    if (std::abs(area) < 1e-6f) {
+      return;
+    }
+
+    // Occluders are double sided, so flip back facing triangles instead of culling them
+    if (area < 0.f) {
+      std::swap(b, c);
+      area = -area;
+    }
+
+    const auto widthF = static_cast<float>(width);
+    const auto heightF = static_cast<float>(height);
+    const auto minX = std::max(std::floor(std::min({a.x, b.x, c.x})), 0.f);
+    const auto minY = std::max(std::floor(std::min({a.y, b.y, c.y})), 0.f);
+    const auto maxX = std::min(std::ceil(std::max({a.x, b.x, c.x})), widthF);
+    const auto maxY = std::min(std::ceil(std::max({a.y, b.y, c.y})), heightF);
+    if (minX >= maxX || minY >= maxY) {
+      return;
+    }
+
+    const auto x0 = static_cast<size_t>(minX);
+    const auto y0 = static_cast<size_t>(minY);
+    const auto x1 = static_cast<size_t>(maxX);
+    const auto y1 = static_cast<size_t>(maxY);
+
+    // Edge functions and inverse depth are affine in screen space, so step them along each row
+    const auto inverseArea = 1.f / area;
+    const auto stepX0 = -(c.y - b.y);
+    const auto stepX1 = -(a.y - c.y);
+    const auto stepX2 = -(b.y - a.y);
+    const auto stepInverseDepth =
+      (stepX0 * a.inverseDepth + stepX1 * b.inverseDepth + stepX2 * c.inverseDepth) * inverseArea;
+
+    for (auto y = y0; y < y1; y++) {
+      const auto pixelY = static_cast<float>(y) + 0.5f;
+      const auto pixelX = static_cast<float>(x0) + 0.5f;
+
+      const auto rowEdge0 = edgeFunction(b.x, b.y, c.x, c.y, pixelX, pixelY);
+      const auto rowEdge1 = edgeFunction(c.x, c.y, a.x, a.y, pixelX, pixelY);
+      const auto rowEdge2 = edgeFunction(a.x, a.y, b.x, b.y, pixelX, pixelY);
+      const auto rowInverseDepth =
+        (rowEdge0 * a.inverseDepth + rowEdge1 * b.inverseDepth + rowEdge2 * c.inverseDepth) * inverseArea;
+
+      auto* row = &inverseDepths[y * width + x0];
+      const auto count = static_cast<int32_t>(x1 - x0);
+
+      // Inverse depths are never negative, so they order the same as their bit patterns. Comparing those as integers
+      // and masking with the edges' sign bits keeps the loop free of float compares, which would block vectorisation
+      for (int32_t i = 0; i < count; i++) {
+        const auto offset = static_cast<float>(i);
+        const auto edge0 = rowEdge0 + stepX0 * offset;
+        const auto edge1 = rowEdge1 + stepX1 * offset;
+        const auto edge2 = rowEdge2 + stepX2 * offset;
+        const auto inverseDepth = rowInverseDepth + stepInverseDepth * offset;
+
+        const auto outside =
+          (std::bit_cast<int32_t>(edge0) | std::bit_cast<int32_t>(edge1) | std::bit_cast<int32_t>(edge2)) >> 31;
+        const auto candidate = std::bit_cast<int32_t>(inverseDepth) & ~outside;
+        row[i] = std::bit_cast<float>(std::max(std::bit_cast<int32_t>(row[i]), candidate));
+      }
+    }
+
+    updateTiles(x0 / TILE_SIZE, y0 / TILE_SIZE, (x1 - 1) / TILE_SIZE, (y1 - 1) / TILE_SIZE);
+  }
+
+  void OcclusionBuffer::updateTiles(
+    const size_t minTileX, const size_t minTileY, const size_t maxTileX, const size_t maxTileY
+  ) {
+    for (auto tileY = minTileY; tileY <= maxTileY; tileY++) {
+      for (auto tileX = minTileX; tileX <= maxTileX; tileX++) {
+        auto tileInverseDepth = std::numeric_limits<float>::max();
+
+        for (size_t y = tileY * TILE_SIZE; y < (tileY + 1) * TILE_SIZE; y++) {
+          const auto* row = &inverseDepths[y * width + tileX * TILE_SIZE];
+          for (size_t x = 0; x < TILE_SIZE; x++) {
+            tileInverseDepth = std::min(tileInverseDepth, row[x]);
+          }
+        }
+
+        tileInverseDepths[tileY * tilesX + tileX] = tileInverseDepth;
+      }
+    }
+  }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include "../static-props/static-prop-table.hpp"
+#include "../structs/common.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Viewpoint occluders are rasterised from. Uses the engine's axes, so forward and up must not be parallel.
+   */
+  struct OcclusionCamera {
+    Structs::Vector position;
+    Structs::Vector forward{1.f, 0.f, 0.f};
+    Structs::Vector up{0.f, 0.f, 1.f};
+
+    float horizontalFovDegrees = 90.f;
+
+    /**
+     * Distance to the near plane. Boxes crossing it are never occluded.
+     */
+    float nearDistance = 1.f;
+  };
+
+  /**
+   * Coarse software depth buffer for culling against func_occluder geometry without a GPU.
+   * Stores the inverse depth of the nearest occluder in each pixel, with the minimum of each 8x8 tile kept alongside
+   * so most box tests are answered without touching individual pixels.
+   * @note Occluders cover the pixels whose centres they contain, so boxes peeking out by less than a pixel past an
+   * occluder's silhouette may be reported as occluded. Use a higher resolution if that matters.
+   */
+  class OcclusionBuffer {
+  public:
+    static constexpr size_t TILE_SIZE = 8;
+    static constexpr size_t DEFAULT_WIDTH = 256;
+    static constexpr size_t DEFAULT_HEIGHT = 128;
+
+    /**
+     * @param width Width in pixels. Must be a non-zero multiple of TILE_SIZE.
+     * @param height Height in pixels. Must be a non-zero multiple of TILE_SIZE.
+     * @throws std::invalid_argument The dimensions are not non-zero multiples of TILE_SIZE.
+     */
+    explicit OcclusionBuffer(size_t width = DEFAULT_WIDTH, size_t height = DEFAULT_HEIGHT);
+
+    /**
+     * Clears the buffer and moves it to a new viewpoint.
+     */
+    void setCamera(const OcclusionCamera& camera);
+
+    /**
+     * Rasterises every active occluder in the BSP.
+     * @throws Errors::OutOfBoundsAccess An occluder references out of bounds polygons or vertices.
+     */
+    void rasteriseOccluders(const Bsp& bsp);
+
+    /**
+     * Rasterises a convex polygon as an occluder. Both sides occlude.
+     */
+    void rasterisePolygon(std::span<const Structs::Vector> polygon);
+
+    /**
+     * Whether an axis-aligned box is entirely hidden behind rasterised occluders.
+     * Boxes outside the camera's view are not occluded, so frustum culling is left to the caller.
+     */
+    [[nodiscard]] bool isBoxOccluded(const Structs::Vector& min, const Structs::Vector& max) const;
+
+    /**
+     * Tests many boxes in parallel.
+     * @param visible Receives 1 for each box which is not occluded and 0 otherwise. Must be at least mins.size() long.
+     * @return Number of visible boxes.
+     * @throws std::invalid_argument The spans differ in length.
+     */
+    size_t testBoxes(
+      std::span<const Structs::Vector> mins, std::span<const Structs::Vector> maxs, std::span<uint8_t> visible
+    ) const;
+
+    /**
+     * Tests the bounds of every face, using the displaced surface for displacement faces.
+     * @param visible Receives a flag per face in bsp.faces. Must be at least bsp.faces.size() long.
+     * @return Number of visible faces.
+     * @throws Errors::OutOfBoundsAccess A face references out of bounds edges or displacements.
+     */
+    size_t testFaces(const Bsp& bsp, std::span<uint8_t> visible) const;
+
+    /**
+     * Tests the world bounds of every static prop. Model bounds aren't stored in the BSP, so come from the caller.
+     * @param modelMins Local bounds minimum of each static prop dictionary entry.
+     * @param modelMaxs Local bounds maximum of each static prop dictionary entry.
+     * @param visible Receives a flag per prop in table. Must be at least table.size() long.
+     * @return Number of visible props.
+     * @throws std::invalid_argument The model bounds don't cover the dictionary entries the props use.
+     */
+    size_t testStaticProps(
+      const StaticPropTable& table,
+      std::span<const Structs::Vector> modelMins,
+      std::span<const Structs::Vector> modelMaxs,
+      std::span<uint8_t> visible
+    ) const;
+
+    [[nodiscard]] size_t getWidth() const;
+    [[nodiscard]] size_t getHeight() const;
+
+    /**
+     * Inverse view depth of the nearest occluder in each pixel, row by row from the top left, or 0 if uncovered.
+     */
+    [[nodiscard]] std::span<const float> getInverseDepths() const;
+
+  private:
+    struct ScreenVertex {
+      float x;
+      float y;
+      float inverseDepth;
+    };
+
+    size_t width;
+    size_t height;
+    size_t tilesX;
+    size_t tilesY;
+
+    Structs::Vector position;
+    Structs::Vector right;
+    Structs::Vector up;
+    Structs::Vector forward;
+    float nearDistance = 1.f;
+    float xScale = 1.f;
+    float yScale = 1.f;
+
+    std::vector<float> inverseDepths;
+
+    /**
+     * Minimum inverse depth of each tile, so anything nearer than it is in front of every occluder in the tile.
+     */
+    std::vector<float> tileInverseDepths;
+
+    std::vector<Structs::Vector> clipScratch;
+    std::vector<Structs::Vector> clipOutput;
+
+    [[nodiscard]] Structs::Vector toView(const Structs::Vector& point) const;
+
+    [[nodiscard]] ScreenVertex project(const Structs::Vector& viewPoint) const;
+
+    void rasteriseTriangle(ScreenVertex a, ScreenVertex b, ScreenVertex c);
+
+    void updateTiles(size_t minTileX, size_t minTileY, size_t maxTileX, size_t maxTileY);
+  };
+}
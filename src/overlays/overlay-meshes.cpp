@@ -0,0 +1,430 @@
+#include "overlay-meshes.hpp"
+#include "../helpers/calculate-uvs.hpp"
+#include "../helpers/get-vertex-position.hpp"
+#include "../helpers/parallel-for.hpp"
+#include "../helpers/vector-maths.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace BspParser {
+  using namespace Internal;
+
+  namespace {
+    struct ClipVertex {
+      Structs::Vector position;
+      Structs::Vector normal;
+
+      /**
+       * Lightmap coordinates of the face being clipped against, which are affine in position so survive clipping.
+       */
+      Structs::Vector2 lightmapUv;
+
+      /**
+       * Coordinates in the overlay's basis plane.
+       */
+      Structs::Vector2 planar;
+    };
+
+    struct OverlayProjection {
+      Structs::Vector origin;
+      Structs::Vector basisU;
+      Structs::Vector basisV;
+
+      std::array<Structs::Vector2, 4> corners;
+      Structs::Vector2 cornersMin;
+      Structs::Vector2 cornersMax;
+
+      /**
+       * 1 if the corners wind anticlockwise in the basis plane, -1 otherwise.
+       */
+      float winding = 1.f;
+
+      std::array<float, 2> u{};
+      std::array<float, 2> v{};
+    };
+
+    struct GeneratedFragment {
+      OverlayFragment info;
+      std::vector<Vertex> vertices;
+      std::vector<uint32_t> vertexFaceIndices;
+      std::vector<uint32_t> indices;
+    };
+
+    float cross2d(const Structs::Vector2& a, const Structs::Vector2& b) {
+      return a.x * b.y - a.y * b.x;
+    }
+
+    template <class OverlayType>
+    OverlayProjection createProjection(const OverlayType& overlay) {
+      OverlayProjection projection;
+      projection.origin = overlay.origin;
+      projection.u = overlay.u;
+      projection.v = overlay.v;
+
+      // The U axis is packed into the otherwise unused z components of the UV points
+      projection.basisU = Structs::Vector{overlay.uvPoints[0].z, overlay.uvPoints[1].z, overlay.uvPoints[2].z};
+      projection.basisV = cross(overlay.basisNormal, projection.basisU);
+      if (overlay.uvPoints[3].z == 1.f) {
+        projection.basisV = mul(projection.basisV, -1.f);
+      }
+
+      auto signedArea = 0.f;
+      for (size_t corner = 0; corner < 4; corner++) {
+        projection.corners[corner] = Structs::Vector2{overlay.uvPoints[corner].x, overlay.uvPoints[corner].y};
+      }
+
+      projection.cornersMin = projection.corners[0];
+      projection.cornersMax = projection.corners[0];
+      for (size_t corner = 0; corner < 4; corner++) {
+        const auto& point = projection.corners[corner];
+        signedArea += cross2d(point, projection.corners[(corner + 1) % 4]);
+
+        projection.cornersMin = Structs::Vector2{
+          std::min(projection.cornersMin.x, point.x),
+          std::min(projection.cornersMin.y, point.y),
+        };
+        projection.cornersMax = Structs::Vector2{
+          std::max(projection.cornersMax.x, point.x),
+          std::max(projection.cornersMax.y, point.y),
+        };
+      }
+
+      projection.winding = signedArea < 0.f ? -1.f : 1.f;
+      return projection;
+    }
+
+    ClipVertex createClipVertex(
+      const OverlayProjection& projection,
+      const Structs::Vector& position,
+      const Structs::Vector& normal,
+      const Structs::Vector2& lightmapUv
+    ) {
+      const auto offset = sub(position, projection.origin);
+
+      return ClipVertex{
+        .position = position,
+        .normal = normal,
+        .lightmapUv = lightmapUv,
+        .planar = Structs::Vector2{dot(offset, projection.basisU), dot(offset, projection.basisV)},
+      };
+    }
+
+    ClipVertex lerpClipVertex(const ClipVertex& a, const ClipVertex& b, const float t) {
+      return ClipVertex{
+        .position = lerp(a.position, b.position, t),
+        .normal = lerp(a.normal, b.normal, t),
+        .lightmapUv = add(a.lightmapUv, mul(sub(b.lightmapUv, a.lightmapUv), t)),
+        .planar = add(a.planar, mul(sub(b.planar, a.planar), t)),
+      };
+    }
+
+    /**
+     * Sutherland-Hodgman clip of a convex polygon against each edge of the overlay quad.
+     */
+    void clipToQuad(
+      const OverlayProjection& projection, std::vector<ClipVertex>& polygon, std::vector<ClipVertex>& scratch
+    ) {
+      for (size_t edge = 0; edge < 4 && !polygon.empty(); edge++) {
+        const auto& edgeStart = projection.corners[edge];
+        const auto edgeDirection = sub(projection.corners[(edge + 1) % 4], edgeStart);
+
+        const auto getDistance = [&](const ClipVertex& vertex) {
+          return projection.winding * cross2d(edgeDirection, sub(vertex.planar, edgeStart));
+        };
+
+        scratch.clear();
+        for (size_t i = 0; i < polygon.size(); i++) {
+          const auto& current = polygon[i];
+          const auto& next = polygon[(i + 1) % polygon.size()];
+          const auto currentDistance = getDistance(current);
+          const auto nextDistance = getDistance(next);
+
+          if (currentDistance >= 0.f) {
+            scratch.push_back(current);
+          }
+
+          if ((currentDistance >= 0.f) != (nextDistance >= 0.f)) {
+            scratch.push_back(lerpClipVertex(current, next, currentDistance / (currentDistance - nextDistance)));
+          }
+        }
+
+        std::swap(polygon, scratch);
+      }
+    }
+
+    /**
+     * Maps a point in the basis plane to (0-1, 0-1) within the quad, inverting its bilinear parameterisation.
+     * Corner 0 is (0, 0), corner 1 (0, 1), corner 2 (1, 1) and corner 3 (1, 0), as the engine assigns texture
+     * coordinates.
+     */
+    Structs::Vector2 invertBilinear(const OverlayProjection& projection, const Structs::Vector2& point) {
+      // https://iquilezles.org/articles/ibilinear/
+      const auto& a = projection.corners[0];
+      const auto e = sub(projection.corners[3], a);
+      const auto f = sub(projection.corners[1], a);
+      const auto g = add(sub(a, projection.corners[3]), sub(projection.corners[2], projection.corners[1]));
+      const auto h = sub(point, a);
+
+      const auto k2 = cross2d(g, f);
+      const auto k1 = cross2d(e, f) + cross2d(h, g);
+      const auto k0 = cross2d(h, e);
+
+      const auto solveS = [&](const float t) {
+        const auto denominatorX = e.x + g.x * t;
+        const auto denominatorY = e.y + g.y * t;
+
+        return std::abs(denominatorX) > std::abs(denominatorY) ? (h.x - f.x * t) / denominatorX
+                                                               : (h.y - f.y * t) / denominatorY;
+      };
+
+      // Parallelograms make the quadratic term vanish
+      if (std::abs(k2) < 1e-6f * std::abs(k1)) {
+        const auto t = -k0 / k1;
+        return Structs::Vector2{solveS(t), t};
+      }
+
+      const auto root = std::sqrt(std::max(k1 * k1 - 4.f * k0 * k2, 0.f));
+      auto t = (-k1 - root) / (2.f * k2);
+      auto s = solveS(t);
+
+      if (s < -1e-3f || s > 1.001f || t < -1e-3f || t > 1.001f) {
+        t = (-k1 + root) / (2.f * k2);
+        s = solveS(t);
+      }
+
+      return Structs::Vector2{s, t};
+    }
+
+    void appendPolygon(
+      const OverlayProjection& projection,
+      const std::vector<ClipVertex>& polygon,
+      const uint32_t faceIndex,
+      const float normalOffset,
+      GeneratedFragment& fragment
+    ) {
+      if (polygon.size() < 3) {
+        return;
+      }
+
+      const auto firstVertex = static_cast<uint32_t>(fragment.vertices.size());
+
+      for (const auto& clipVertex : polygon) {
+        const auto normal = normalise(clipVertex.normal);
+        const auto quadCoordinates = invertBilinear(projection, clipVertex.planar);
+
+        const auto tangent = normalise(sub(projection.basisU, mul(normal, dot(normal, projection.basisU))));
+        const auto handedness = dot(cross(normal, tangent), projection.basisV) < 0.f ? -1.f : 1.f;
+
+        fragment.vertices.push_back(
+          Vertex{
+            .position = add(clipVertex.position, mul(normal, normalOffset)),
+            .normal = normal,
+            .tangent = Structs::Vector4{tangent.x, tangent.y, tangent.z, handedness},
+            .uv =
+              Structs::Vector2{
+                projection.u[0] + (projection.u[1] - projection.u[0]) * quadCoordinates.x,
+                projection.v[0] + (projection.v[1] - projection.v[0]) * quadCoordinates.y,
+              },
+            .lightmapUv = clipVertex.lightmapUv,
+            .alpha = 1.f,
+          }
+        );
+        fragment.vertexFaceIndices.push_back(faceIndex);
+      }
+
+      for (uint32_t i = 1; i + 1 < polygon.size(); i++) {
+        fragment.indices.push_back(firstVertex);
+        fragment.indices.push_back(firstVertex + i);
+        fragment.indices.push_back(firstVertex + i + 1);
+      }
+    }
+
+    bool overlapsQuad(const OverlayProjection& projection, const std::vector<ClipVertex>& polygon) {
+      auto min = polygon.front().planar;
+      auto max = polygon.front().planar;
+      for (const auto& vertex : polygon) {
+        min = Structs::Vector2{std::min(min.x, vertex.planar.x), std::min(min.y, vertex.planar.y)};
+        max = Structs::Vector2{std::max(max.x, vertex.planar.x), std::max(max.y, vertex.planar.y)};
+      }
+
+      return max.x >= projection.cornersMin.x && min.x <= projection.cornersMax.x &&
+        max.y >= projection.cornersMin.y && min.y <= projection.cornersMax.y;
+    }
+
+    template <class OverlayType>
+    GeneratedFragment generateFragment(
+      const Bsp& bsp,
+      const OverlayType& overlay,
+      const uint32_t overlayIndex,
+      const bool isWater,
+      const float normalOffset
+    ) {
+      const auto lump = isWater ? Enums::Lump::WaterOverlays : Enums::Lump::Overlays;
+
+      if (overlay.texInfo < 0 || overlay.texInfo >= bsp.textureInfos.size()) {
+        throw Errors::OutOfBoundsAccess(
+          lump,
+          std::format("Overlay texture info index '{}' is out of bounds of the texture info lump", overlay.texInfo)
+        );
+      }
+
+      const auto faceCount = static_cast<size_t>(overlay.faceCountAndRenderOrder & Structs::OVERLAY_FACE_COUNT_MASK);
+      if (faceCount > overlay.faces.size()) {
+        throw Errors::InvalidBody(
+          lump, std::format("Overlay face count ({}) exceeds the maximum of {}", faceCount, overlay.faces.size())
+        );
+      }
+
+      GeneratedFragment fragment;
+      fragment.info = OverlayFragment{
+        .overlayIndex = overlayIndex,
+        .isWater = isWater,
+        .renderOrder = static_cast<uint8_t>(overlay.faceCountAndRenderOrder >> Structs::OVERLAY_RENDER_ORDER_SHIFT),
+        .texInfo = overlay.texInfo,
+        .texData = bsp.textureInfos[overlay.texInfo].texData,
+      };
+
+      const auto projection = createProjection(overlay);
+      std::vector<ClipVertex> polygon;
+      std::vector<ClipVertex> scratch;
+
+      const auto clipAndAppend = [&](const uint32_t faceIndex) {
+        if (!polygon.empty() && overlapsQuad(projection, polygon)) {
+          clipToQuad(projection, polygon, scratch);
+          appendPolygon(projection, polygon, faceIndex, normalOffset, fragment);
+        }
+      };
+
+      for (const auto faceIndex : std::span(overlay.faces).first(faceCount)) {
+        if (faceIndex < 0 || faceIndex >= bsp.faces.size()) {
+          throw Errors::OutOfBoundsAccess(
+            lump, std::format("Overlay face index '{}' is out of bounds of the faces lump", faceIndex)
+          );
+        }
+
+        const auto& face = bsp.faces[faceIndex];
+
+        if (face.dispInfo >= 0) {
+          if (face.dispInfo >= bsp.displacements.size()) {
+            throw Errors::OutOfBoundsAccess(
+              Enums::Lump::Faces,
+              std::format("Face displacement index '{}' is out of bounds of the displacements", face.dispInfo)
+            );
+          }
+
+          const auto& displacementVertices = bsp.displacements[face.dispInfo].vertices;
+          bsp.displacements[face.dispInfo].generateTriangleListIndices(
+            [&](const uint32_t i0, const uint32_t i1, const uint32_t i2) {
+              polygon.clear();
+              for (const auto index : {i0, i1, i2}) {
+                const auto& vertex = displacementVertices[index];
+                polygon.push_back(createClipVertex(projection, vertex.position, vertex.normal, vertex.lightmapUv));
+              }
+
+              clipAndAppend(static_cast<uint32_t>(faceIndex));
+            }
+          );
+          continue;
+        }
+
+        if (face.firstEdge < 0 || face.numEdges < 3 || face.firstEdge + face.numEdges > bsp.surfaceEdges.size() ||
+            face.planeNum >= bsp.planes.size() || face.texInfo < 0 || face.texInfo >= bsp.textureInfos.size()) {
+          continue;
+        }
+
+        const auto& normal = bsp.planes[face.planeNum].normal;
+        const auto& faceTextureInfo = bsp.textureInfos[face.texInfo];
+
+        polygon.clear();
+        for (const auto surfaceEdge : bsp.surfaceEdges.subspan(face.firstEdge, face.numEdges)) {
+          const auto& position = getVertexPosition(bsp.edges, bsp.vertices, surfaceEdge);
+          polygon.push_back(
+            createClipVertex(projection, position, normal, calculateLightmapUvs(position, faceTextureInfo, face))
+          );
+        }
+
+        clipAndAppend(static_cast<uint32_t>(faceIndex));
+      }
+
+      fragment.info.vertexCount = static_cast<uint32_t>(fragment.vertices.size());
+      fragment.info.indexCount = static_cast<uint32_t>(fragment.indices.size());
+
+      return fragment;
+    }
+  }
+
+  OverlayMeshes::OverlayMeshes(const Bsp& bsp, const float normalOffset) {
+    const auto numOverlays = bsp.overlays.size() + bsp.waterOverlays.size();
+    std::vector<GeneratedFragment> generated(numOverlays);
+
+    // Clipping dominates, and each overlay is independent
+    parallelFor(
+      numOverlays,
+      [&](const size_t index) {
+        if (index < bsp.overlays.size()) {
+          generated[index] =
+            generateFragment(bsp, bsp.overlays[index], static_cast<uint32_t>(index), false, normalOffset);
+        } else {
+          const auto waterIndex = index - bsp.overlays.size();
+          generated[index] =
+            generateFragment(bsp, bsp.waterOverlays[waterIndex], static_cast<uint32_t>(waterIndex), true, normalOffset);
+        }
+      },
+      16
+    );
+
+    std::vector<size_t> order;
+    order.reserve(numOverlays);
+    for (size_t index = 0; index < numOverlays; index++) {
+      if (!generated[index].indices.empty()) {
+        order.push_back(index);
+      }
+    }
+
+    std::ranges::stable_sort(order, [&generated](const size_t a, const size_t b) {
+      const auto& infoA = generated[a].info;
+      const auto& infoB = generated[b].info;
+
+      return std::tie(infoA.isWater, infoA.texData, infoA.renderOrder) <
+        std::tie(infoB.isWater, infoB.texData, infoB.renderOrder);
+    });
+
+    fragments.reserve(order.size());
+    for (const auto index : order) {
+      auto& fragment = generated[index];
+      fragment.info.firstVertex = static_cast<uint32_t>(vertices.size());
+      fragment.info.firstIndex = static_cast<uint32_t>(indices.size());
+
+      vertices.insert(vertices.end(), fragment.vertices.begin(), fragment.vertices.end());
+      vertexFaceIndices.insert(
+        vertexFaceIndices.end(), fragment.vertexFaceIndices.begin(), fragment.vertexFaceIndices.end()
+      );
+      for (const auto vertexIndex : fragment.indices) {
+        indices.push_back(fragment.info.firstVertex + vertexIndex);
+      }
+
+      const auto startsBatch = batches.empty() || batches.back().isWater != fragment.info.isWater ||
+        batches.back().texData != fragment.info.texData;
+
+      if (startsBatch) {
+        batches.push_back(
+          OverlayBatch{
+            .texData = fragment.info.texData,
+            .isWater = fragment.info.isWater,
+            .firstFragment = static_cast<uint32_t>(fragments.size()),
+            .firstIndex = fragment.info.firstIndex,
+          }
+        );
+      }
+
+      batches.back().fragmentCount++;
+      batches.back().indexCount += fragment.info.indexCount;
+      fragments.push_back(fragment.info);
+    }
+  }
+
+  std::span<const OverlayFragment> OverlayMeshes::getFragments(const OverlayBatch& batch) const {
+    return std::span(fragments).subspan(batch.firstFragment, batch.fragmentCount);
+  }
+}
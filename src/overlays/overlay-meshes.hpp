@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include "../vertex.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Geometry generated for a single overlay or water overlay.
+   */
+  struct OverlayFragment {
+    /**
+     * Index into Bsp::overlays, or Bsp::waterOverlays if isWater is set.
+     */
+    uint32_t overlayIndex = 0;
+    bool isWater = false;
+    uint8_t renderOrder = 0;
+    int16_t texInfo = -1;
+    int32_t texData = -1;
+
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+  };
+
+  /**
+   * Range of fragments sharing a material, drawable with a single call.
+   */
+  struct OverlayBatch {
+    int32_t texData = -1;
+    bool isWater = false;
+
+    uint32_t firstFragment = 0;
+    uint32_t fragmentCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+  };
+
+  /**
+   * Meshes for every overlay and water overlay, made by clipping each overlay's quad against the faces it references.
+   * Overlays are clipped in parallel, then sorted by material so each batch is a contiguous index range.
+   */
+  struct OverlayMeshes {
+    /**
+     * Distance overlays are pushed off their surfaces to avoid z-fighting, matching the engine.
+     */
+    static constexpr float DEFAULT_NORMAL_OFFSET = 0.1f;
+
+    OverlayMeshes() = default;
+
+    /**
+     * @param bsp BSP instance. Displacement normals are taken as they are, so smooth them first if needed.
+     * @param normalOffset Distance to push overlay vertices along the surface normal.
+     * @throws Errors::OutOfBoundsAccess An overlay references an out of bounds face or texture info.
+     */
+    explicit OverlayMeshes(const Bsp& bsp, float normalOffset = DEFAULT_NORMAL_OFFSET);
+
+    std::vector<Vertex> vertices;
+
+    /**
+     * Index into Bsp::faces of the face each vertex was clipped against, parallel to vertices.
+     * Vertex::lightmapUv is within this face's lightmap, so use it to remap vertices into a LightmapAtlas.
+     */
+    std::vector<uint32_t> vertexFaceIndices;
+
+    /**
+     * Triangle list indices into vertices, clockwise like the face triangulation.
+     */
+    std::vector<uint32_t> indices;
+
+    /**
+     * Fragments ordered by water, then material, then render order, then overlay index. Overlays which don't
+     * touch any of their faces have no fragment.
+     */
+    std::vector<OverlayFragment> fragments;
+
+    std::vector<OverlayBatch> batches;
+
+    [[nodiscard]] std::span<const OverlayFragment> getFragments(const OverlayBatch& batch) const;
+  };
+}
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <span>
+#include <vector>
 
 namespace BspParser {
   /**
@@ -23,6 +24,12 @@ namespace BspParser {
      */
     std::span<const std::byte> collisionData;
 
+    /**
+     * collisionData split into its solids, each a view starting with the solid's int32 size prefix.
+     * Pass one to `PhyParser::parseSurfaces` with a solid count of 1 to parse solids independently, e.g. in parallel.
+     */
+    std::vector<std::span<const std::byte>> solids;
+
     /**
      * Raw .PHY text section data. Use `PhyParser::parseTextSection` from the accompanying PHYParser library to parse this.
      */
@@ -0,0 +1,50 @@
+#include "static-prop-batches.hpp"
+
+namespace BspParser {
+  StaticPropBatches::StaticPropBatches(const Bsp& bsp) {
+    const auto& table = bsp.staticPropTable;
+    if (table.empty() || !bsp.staticPropDictionary.has_value()) {
+      return;
+    }
+
+    const auto& dictionary = bsp.staticPropDictionary.value();
+
+    // Counting sort by dictionary index keeps this linear and preserves lump order within each batch
+    std::vector<size_t> batchOffsets(dictionary.size() + 1, 0);
+    for (const auto dictionaryIndex : table.dictionaryIndices) {
+      batchOffsets[dictionaryIndex + 1]++;
+    }
+
+    for (size_t dictionaryIndex = 0; dictionaryIndex < dictionary.size(); dictionaryIndex++) {
+      const auto instanceCount = batchOffsets[dictionaryIndex + 1];
+      batchOffsets[dictionaryIndex + 1] += batchOffsets[dictionaryIndex];
+
+      if (instanceCount > 0) {
+        batches.push_back(
+          StaticPropBatch{
+            .dictionaryIndex = static_cast<uint16_t>(dictionaryIndex),
+            .modelPath = dictionary[dictionaryIndex].modelName.data(),
+            .firstInstance = batchOffsets[dictionaryIndex],
+            .instanceCount = instanceCount,
+          }
+        );
+      }
+    }
+
+    instances.resize(table.size());
+    for (uint32_t propIndex = 0; propIndex < table.size(); propIndex++) {
+      auto& instance = instances[batchOffsets[table.dictionaryIndices[propIndex]]++];
+
+      instance.transform = table.transforms[propIndex];
+      instance.skin = table.skins[propIndex];
+      instance.fadeMinDistance = table.fadeMinDistances[propIndex];
+      instance.fadeMaxDistance = table.fadeMaxDistances[propIndex];
+      instance.forcedFadeScale = table.forcedFadeScales[propIndex];
+      instance.propIndex = propIndex;
+    }
+  }
+
+  std::span<const StaticPropInstance> StaticPropBatches::getInstances(const StaticPropBatch& batch) const {
+    return std::span(instances).subspan(batch.firstInstance, batch.instanceCount);
+  }
+}
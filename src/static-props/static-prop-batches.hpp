@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include "../matrix.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Per-instance data for rendering or simulating a static prop. Plain data, ready to upload as an instance buffer.
+   */
+  struct StaticPropInstance {
+    /**
+     * Local to world transform.
+     */
+    Matrix3x4 transform;
+
+    int32_t skin = 0;
+    float fadeMinDistance = 0.f;
+    float fadeMaxDistance = 0.f;
+    float forcedFadeScale = 1.f;
+
+    /**
+     * Index of the prop in Bsp::staticPropTable.
+     */
+    uint32_t propIndex = 0;
+  };
+
+  /**
+   * Range of instances sharing a single static prop model.
+   */
+  struct StaticPropBatch {
+    uint16_t dictionaryIndex = 0;
+
+    /**
+     * Null-terminated model path from the static prop dictionary.
+     */
+    const char* modelPath = nullptr;
+
+    size_t firstInstance = 0;
+    size_t instanceCount = 0;
+  };
+
+  /**
+   * Static prop instances bucketed by model, so each model can be drawn or cooked with a single contiguous buffer.
+   */
+  struct StaticPropBatches {
+    explicit StaticPropBatches(const Bsp& bsp);
+
+    /**
+     * All instances, contiguous per batch and ordered by dictionary index.
+     */
+    std::vector<StaticPropInstance> instances;
+
+    /**
+     * One batch per dictionary entry with at least one instance.
+     */
+    std::vector<StaticPropBatch> batches;
+
+    [[nodiscard]] std::span<const StaticPropInstance> getInstances(const StaticPropBatch& batch) const;
+  };
+}
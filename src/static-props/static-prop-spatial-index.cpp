@@ -0,0 +1,117 @@
+#include "static-prop-spatial-index.hpp"
+#include "../helpers/vector-maths.hpp"
+#include <algorithm>
+
+namespace BspParser {
+  using namespace Internal;
+
+  StaticPropSpatialIndex::StaticPropSpatialIndex(const StaticPropTable& table) :
+    origins(table.origins),
+    fadeMinDistances(table.fadeMinDistances),
+    fadeMaxDistances(table.fadeMaxDistances),
+    originGrid(table.origins, table.origins) {
+    std::vector<Structs::Vector> fadeMins;
+    std::vector<Structs::Vector> fadeMaxs;
+
+    for (uint32_t propIndex = 0; propIndex < origins.size(); propIndex++) {
+      const auto fadeDistance = fadeMaxDistances[propIndex];
+      if (fadeDistance <= 0.f) {
+        nonFadingProps.push_back(propIndex);
+        continue;
+      }
+
+      const auto extent = Structs::Vector{fadeDistance, fadeDistance, fadeDistance};
+      fadingProps.push_back(propIndex);
+      fadeMins.push_back(sub(origins[propIndex], extent));
+      fadeMaxs.push_back(add(origins[propIndex], extent));
+      maxFadeDistance = std::max(maxFadeDistance, fadeDistance);
+    }
+
+    fadeGrid = SpatialGrid(fadeMins, fadeMaxs, maxFadeDistance);
+  }
+
+  size_t StaticPropSpatialIndex::queryRadius(
+    const Structs::Vector& centre, const float radius, const std::span<uint32_t> output
+  ) const {
+    const auto extent = Structs::Vector{radius, radius, radius};
+    const auto radiusSquared = radius * radius;
+
+    size_t numFound = 0;
+    originGrid.queryBox(sub(centre, extent), add(centre, extent), [&](const uint32_t propIndex) {
+      const auto delta = sub(origins[propIndex], centre);
+      if (dot(delta, delta) > radiusSquared) {
+        return;
+      }
+
+      if (numFound < output.size()) {
+        output[numFound] = propIndex;
+      }
+      numFound++;
+    });
+
+    return numFound;
+  }
+
+  size_t StaticPropSpatialIndex::queryBox(
+    const Structs::Vector& min, const Structs::Vector& max, const std::span<uint32_t> output
+  ) const {
+    size_t numFound = 0;
+    originGrid.queryBox(min, max, [&](const uint32_t propIndex) {
+      if (numFound < output.size()) {
+        output[numFound] = propIndex;
+      }
+      numFound++;
+    });
+
+    return numFound;
+  }
+
+  size_t StaticPropSpatialIndex::queryNearest(const Structs::Vector& point, const std::span<uint32_t> output) const {
+    return originGrid.queryNearest(point, output);
+  }
+
+  size_t StaticPropSpatialIndex::queryUnfaded(
+    const Structs::Vector& viewOrigin,
+    const std::span<uint32_t> output,
+    const std::span<float> fadeAlphas,
+    const float fadeScale
+  ) const {
+    size_t numFound = 0;
+    const auto write = [&](const uint32_t propIndex, const float alpha) {
+      if (numFound < output.size()) {
+        output[numFound] = propIndex;
+
+        if (numFound < fadeAlphas.size()) {
+          fadeAlphas[numFound] = alpha;
+        }
+      }
+      numFound++;
+    };
+
+    for (const auto propIndex : nonFadingProps) {
+      write(propIndex, 1.f);
+    }
+
+    // Fade boxes were built at a scale of 1, so grow the query to cover any scaled-up fade spheres
+    const auto padding = maxFadeDistance * std::max(fadeScale - 1.f, 0.f);
+    const auto extent = Structs::Vector{padding, padding, padding};
+
+    fadeGrid.queryBox(sub(viewOrigin, extent), add(viewOrigin, extent), [&](const uint32_t fadingIndex) {
+      const auto propIndex = fadingProps[fadingIndex];
+      const auto fadeMax = fadeMaxDistances[propIndex] * fadeScale;
+      const auto fadeMin = std::min(std::max(fadeMinDistances[propIndex], 0.f) * fadeScale, fadeMax);
+
+      const auto delta = sub(origins[propIndex], viewOrigin);
+      const auto distanceSquared = dot(delta, delta);
+      if (distanceSquared >= fadeMax * fadeMax) {
+        return;
+      }
+
+      const auto distance = std::sqrt(distanceSquared);
+      const auto alpha = fadeMax > fadeMin ? std::clamp((fadeMax - distance) / (fadeMax - fadeMin), 0.f, 1.f) : 1.f;
+      write(propIndex, alpha);
+    });
+
+    return numFound;
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "static-prop-table.hpp"
+#include "../helpers/spatial-grid.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Uniform grid over static prop origins for proximity and distance-fade queries.
+   * All queries write indices into Bsp::staticPropTable to a caller-supplied buffer and never allocate.
+   */
+  class StaticPropSpatialIndex {
+  public:
+    /**
+     * Builds the index in linear time.
+     * @param table Static prop table to index. Only the origins and fade distances are copied.
+     */
+    explicit StaticPropSpatialIndex(const StaticPropTable& table);
+
+    /**
+     * Finds props whose origin lies within a sphere.
+     * @param output Receives prop indices in no particular order.
+     * @return Total number of matching props, which may exceed the number written if output is too small.
+     */
+    size_t queryRadius(const Structs::Vector& centre, float radius, std::span<uint32_t> output) const;
+
+    /**
+     * Finds props whose origin lies within an axis-aligned box.
+     * @param output Receives prop indices in no particular order.
+     * @return Total number of matching props, which may exceed the number written if output is too small.
+     */
+    size_t queryBox(const Structs::Vector& min, const Structs::Vector& max, std::span<uint32_t> output) const;
+
+    /**
+     * Finds the props closest to a point.
+     * @param output Receives prop indices sorted from nearest to furthest. Its size is the number of props to find.
+     * @return Number of indices written.
+     */
+    size_t queryNearest(const Structs::Vector& point, std::span<uint32_t> output) const;
+
+    /**
+     * Finds props which are not fully faded out when viewed from the given position,
+     * following the fadeMinDist/fadeMaxDist semantics of the engine. Props with no fade distance are always included.
+     * @param viewOrigin Position of the viewer.
+     * @param output Receives prop indices in no particular order.
+     * @param fadeAlphas Optionally receives the fade opacity (0-1) of each prop written to output.
+     * @param fadeScale Multiplier applied to every prop's fade distances.
+     * @return Total number of matching props, which may exceed the number written if output is too small.
+     */
+    size_t queryUnfaded(
+      const Structs::Vector& viewOrigin,
+      std::span<uint32_t> output,
+      std::span<float> fadeAlphas = {},
+      float fadeScale = 1.f
+    ) const;
+
+  private:
+    std::vector<Structs::Vector> origins;
+    std::vector<float> fadeMinDistances;
+    std::vector<float> fadeMaxDistances;
+
+    Internal::SpatialGrid originGrid;
+
+    /**
+     * Grid over the bounding box of each fading prop's fade sphere, letting unfaded queries visit only nearby props.
+     */
+    Internal::SpatialGrid fadeGrid;
+    std::vector<uint32_t> fadingProps;
+    std::vector<uint32_t> nonFadingProps;
+    float maxFadeDistance = 0.f;
+  };
+}
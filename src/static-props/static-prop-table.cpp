@@ -0,0 +1,78 @@
+#include "static-prop-table.hpp"
+#include "../helpers/calculate-transform.hpp"
+
+namespace BspParser {
+  using namespace Internal;
+
+  StaticPropTable::StaticPropTable(
+    const std::span<const Structs::StaticPropDict> dictionary,
+    const std::span<const Structs::StaticPropLeaf> leaves,
+    const StaticPropLump& props
+  ) {
+    std::visit([this, dictionary, leaves](const auto lumpProps) { append(lumpProps, dictionary, leaves); }, props);
+
+    transforms.resize(origins.size());
+    calculateTransforms(origins, angles, transforms);
+  }
+
+  size_t StaticPropTable::size() const {
+    return lumpIndices.size();
+  }
+
+  bool StaticPropTable::empty() const {
+    return lumpIndices.empty();
+  }
+
+  template <class StaticProp>
+  void StaticPropTable::append(
+    const std::span<const StaticProp> props,
+    const std::span<const Structs::StaticPropDict> dictionary,
+    const std::span<const Structs::StaticPropLeaf> leaves
+  ) {
+    lumpIndices.reserve(props.size());
+    origins.reserve(props.size());
+    angles.reserve(props.size());
+    dictionaryIndices.reserve(props.size());
+    flags.reserve(props.size());
+    skins.reserve(props.size());
+    solidTypes.reserve(props.size());
+    fadeMinDistances.reserve(props.size());
+    fadeMaxDistances.reserve(props.size());
+    forcedFadeScales.reserve(props.size());
+    lightingOrigins.reserve(props.size());
+    firstLeaves.reserve(props.size());
+    leafCounts.reserve(props.size());
+
+    for (uint32_t lumpIndex = 0; lumpIndex < props.size(); lumpIndex++) {
+      const auto& prop = props[lumpIndex];
+
+      // TODO: Generate warnings for dropped props
+      if (prop.propType >= dictionary.size()) {
+        continue;
+      }
+
+      if (static_cast<size_t>(prop.firstLeaf) + prop.leafCount > leaves.size()) {
+        continue;
+      }
+
+      lumpIndices.push_back(lumpIndex);
+      origins.push_back(prop.origin);
+      angles.push_back(prop.angles);
+      dictionaryIndices.push_back(prop.propType);
+      flags.push_back(static_cast<uint32_t>(prop.flags));
+      skins.push_back(prop.skin);
+      solidTypes.push_back(prop.solid);
+      fadeMinDistances.push_back(prop.fadeMinDist);
+      fadeMaxDistances.push_back(prop.fadeMaxDist);
+      lightingOrigins.push_back(prop.lightingOrigin);
+      firstLeaves.push_back(prop.firstLeaf);
+      leafCounts.push_back(prop.leafCount);
+
+      if constexpr (requires { prop.flForcedFadeScale; }) {
+        forcedFadeScales.push_back(prop.flForcedFadeScale);
+      } else {
+        forcedFadeScales.push_back(1.f);
+      }
+    }
+  }
+}
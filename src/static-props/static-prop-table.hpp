@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../matrix.hpp"
+#include "../structs/common.hpp"
+#include "../structs/static-props.hpp"
+#include <cstdint>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace BspParser {
+  using StaticPropLump = std::variant<
+    std::span<const Structs::StaticPropV4>,
+    std::span<const Structs::StaticPropV5>,
+    std::span<const Structs::StaticPropV6>,
+    std::span<const Structs::StaticPropV7Multiplayer2013>>;
+
+  /**
+   * Static props normalised across lump versions into a structure of arrays.
+   * Every array has one entry per prop, so loops over a single field stay tightly packed.
+   * @note Props referencing an out of range dictionary entry or leaf range are dropped during normalisation.
+   */
+  struct StaticPropTable {
+    StaticPropTable() = default;
+
+    StaticPropTable(
+      std::span<const Structs::StaticPropDict> dictionary,
+      std::span<const Structs::StaticPropLeaf> leaves,
+      const StaticPropLump& props
+    );
+
+    /**
+     * Index of each prop in the static prop lump.
+     */
+    std::vector<uint32_t> lumpIndices;
+
+    std::vector<Structs::Vector> origins;
+    std::vector<Structs::EulerRotation> angles;
+
+    /**
+     * Local to world transforms built from origins and angles.
+     */
+    std::vector<Matrix3x4> transforms;
+
+    /**
+     * Index into the static prop dictionary for each prop. Always in range.
+     */
+    std::vector<uint16_t> dictionaryIndices;
+
+    /**
+     * Bitwise combination of Enums::StaticPropFlag values, widened to fit all lump versions.
+     */
+    std::vector<uint32_t> flags;
+
+    std::vector<int32_t> skins;
+    std::vector<uint8_t> solidTypes;
+
+    std::vector<float> fadeMinDistances;
+    std::vector<float> fadeMaxDistances;
+
+    /**
+     * Forced fade scale of each prop, or 1 for lump versions which predate it.
+     */
+    std::vector<float> forcedFadeScales;
+
+    std::vector<Structs::Vector> lightingOrigins;
+
+    /**
+     * Index of the first leaf of each prop in the static prop leaf list. Always in range.
+     */
+    std::vector<uint16_t> firstLeaves;
+    std::vector<uint16_t> leafCounts;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] bool empty() const;
+
+  private:
+    template <class StaticProp>
+    void append(
+      std::span<const StaticProp> props,
+      std::span<const Structs::StaticPropDict> dictionary,
+      std::span<const Structs::StaticPropLeaf> leaves
+    );
+  };
+}
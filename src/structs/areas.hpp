@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BspParser::Structs {
+  struct Area {
+    int32_t numAreaPortals;
+    int32_t firstAreaPortal;
+  };
+
+  struct AreaPortal {
+    /**
+     * Matches the portalnumber keyvalue of the func_areaportal entity which opens and closes this portal.
+     */
+    uint16_t portalKey;
+
+    /**
+     * Area this portal looks into.
+     */
+    uint16_t otherArea;
+
+    uint16_t firstClipPortalVertex;
+    uint16_t numClipPortalVertices;
+    int32_t planeNum;
+  };
+}
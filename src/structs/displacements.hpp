@@ -52,4 +52,11 @@ namespace BspParser::Structs {
     float dist;
     float alpha;
   };
+
+  struct DispTri {
+    /**
+     * Bitwise combination of Enums::DispTriFlag values.
+     */
+    uint16_t tags;
+  };
 }
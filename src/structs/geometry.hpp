@@ -1,10 +1,13 @@
 #pragma once
 
 #include "common.hpp"
+#include "../enums/primitive.hpp"
 #include <array>
 #include <cstdint>
 
 namespace BspParser::Structs {
+  constexpr uint16_t PRIMITIVE_COUNT_MASK = 0x7fff;
+
   struct Plane {
     Vector normal; // Normal of the plane
     float distance; // Distance from origin
@@ -38,8 +41,23 @@ namespace BspParser::Structs {
     std::array<int32_t, 2> lightmapTextureMinsInLuxels;
     std::array<int32_t, 2> lightmapTextureSizeInLuxels;
     int32_t originalFace;
-    uint16_t numPrimitives;
+    uint16_t numPrimitives; // Top bit disables dynamic shadows on the face, use PRIMITIVE_COUNT_MASK for the count
     uint16_t firstPrimitiveId;
     uint32_t smoothingGroups;
   };
+
+  /**
+   * Precomputed triangulation of a face, emitted by vbsp when fixing T-junctions.
+   */
+  struct Primitive {
+    Enums::PrimitiveType type;
+    uint16_t firstIndex;
+    uint16_t indexCount;
+
+    /**
+     * Range of PrimitiveVertices used by the primitive. When empty, indices refer to the face's own vertices.
+     */
+    uint16_t firstVertex;
+    uint16_t vertexCount;
+  };
 }
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "common.hpp"
+#include "../enums/lighting.hpp"
+#include "tree.hpp"
+#include <array>
+#include <cstdint>
+
+namespace BspParser::Structs {
+  /**
+   * Range of LeafAmbientLighting samples belonging to a leaf. Indexed the same as the leaves lump.
+   */
+  struct LeafAmbientIndex {
+    uint16_t ambientSampleCount;
+    uint16_t firstAmbientSample;
+  };
+
+  struct LeafAmbientLighting {
+    CompressedLightCube cube;
+
+    /**
+     * Position of the sample within its leaf's bounds, where 0 is the mins and 255 is the maxs.
+     */
+    uint8_t x;
+    uint8_t y;
+    uint8_t z;
+    uint8_t padding;
+  };
+
+  struct CubemapSample {
+    std::array<int32_t, 3> origin;
+
+    /**
+     * Edge length of the cubemap as a power of two plus one, or 0 for the default size.
+     */
+    int32_t size;
+  };
+
+  /**
+   * World light for lump version 0.
+   */
+  struct WorldLightV0 {
+    Vector origin;
+    Vector intensity;
+    Vector normal; // For surfaces and spotlights
+    int32_t cluster;
+    Enums::EmitType type;
+    int32_t style;
+    float stopDot; // Start of penumbra for spotlights
+    float stopDot2; // End of penumbra for spotlights
+    float exponent;
+    float radius; // Cutoff distance, or 0 to derive it from the attenuation
+    float constantAttenuation;
+    float linearAttenuation;
+    float quadraticAttenuation;
+    Enums::WorldLightFlag flags;
+    int32_t texInfo;
+    int32_t owner; // Entity that this light is relative to
+  };
+
+  /**
+   * World light for lump version 1, which adds an offset to the origin used when casting shadows.
+   */
+  struct WorldLightV1 {
+    Vector origin;
+    Vector intensity;
+    Vector normal; // For surfaces and spotlights
+    Vector shadowCastOffset;
+    int32_t cluster;
+    Enums::EmitType type;
+    int32_t style;
+    float stopDot; // Start of penumbra for spotlights
+    float stopDot2; // End of penumbra for spotlights
+    float exponent;
+    float radius; // Cutoff distance, or 0 to derive it from the attenuation
+    float constantAttenuation;
+    float linearAttenuation;
+    float quadraticAttenuation;
+    Enums::WorldLightFlag flags;
+    int32_t texInfo;
+    int32_t owner; // Entity that this light is relative to
+  };
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common.hpp"
+#include <cstdint>
+
+namespace BspParser::Structs {
+  struct OccluderDataV1 {
+    int32_t flags;
+    int32_t firstPoly;
+    int32_t polyCount;
+    Vector mins;
+    Vector maxs;
+  };
+
+  struct OccluderDataV2 {
+    int32_t flags;
+    int32_t firstPoly;
+    int32_t polyCount;
+    Vector mins;
+    Vector maxs;
+    int32_t area;
+  };
+
+  struct OccluderPolyData {
+    /**
+     * Index into the occluder vertex indices of the polygon's first vertex.
+     */
+    int32_t firstVertexIndex;
+    int32_t vertexCount;
+    int32_t planeNum;
+  };
+}
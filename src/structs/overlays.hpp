@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace BspParser::Structs {
+  constexpr size_t OVERLAY_BSP_FACE_COUNT = 64;
+  constexpr size_t WATER_OVERLAY_BSP_FACE_COUNT = 256;
+
+  constexpr uint16_t OVERLAY_FACE_COUNT_MASK = 0x3fff;
+  constexpr uint8_t OVERLAY_RENDER_ORDER_SHIFT = 14;
+
+  struct Overlay {
+    int32_t id;
+    int16_t texInfo;
+
+    /**
+     * Number of faces in the low 14 bits and render order in the top 2 bits.
+     */
+    uint16_t faceCountAndRenderOrder;
+
+    std::array<int32_t, OVERLAY_BSP_FACE_COUNT> faces;
+    std::array<float, 2> u;
+    std::array<float, 2> v;
+
+    /**
+     * Corners of the overlay in the plane of its basis. The z components of the first three hold the U basis axis,
+     * and the last is 1 if the V axis is flipped.
+     */
+    std::array<Vector, 4> uvPoints;
+
+    Vector origin;
+    Vector basisNormal;
+  };
+
+  struct WaterOverlay {
+    int32_t id;
+    int16_t texInfo;
+
+    /**
+     * Number of faces in the low 14 bits and render order in the top 2 bits.
+     */
+    uint16_t faceCountAndRenderOrder;
+
+    std::array<int32_t, WATER_OVERLAY_BSP_FACE_COUNT> faces;
+    std::array<float, 2> u;
+    std::array<float, 2> v;
+
+    /**
+     * Corners of the overlay in the plane of its basis. The z components of the first three hold the U basis axis,
+     * and the last is 1 if the V axis is flipped.
+     */
+    std::array<Vector, 4> uvPoints;
+
+    Vector origin;
+    Vector basisNormal;
+  };
+
+  struct OverlayFade {
+    float fadeDistanceMinSquared;
+    float fadeDistanceMaxSquared;
+  };
+
+  struct OverlaySystemLevel {
+    uint8_t minCpuLevel;
+    uint8_t maxCpuLevel;
+    uint8_t minGpuLevel;
+    uint8_t maxGpuLevel;
+  };
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "common.hpp"
+#include <array>
+#include <cstdint>
+
+namespace BspParser::Structs {
+  struct Node {
+    int32_t planeNum;
+
+    /**
+     * Front and back children. Negative values are leaves, where the leaf index is -1 - child.
+     */
+    std::array<int32_t, 2> children;
+
+    std::array<int16_t, 3> mins;
+    std::array<int16_t, 3> maxs;
+    uint16_t firstFace;
+    uint16_t numFaces;
+    int16_t area;
+    int16_t padding;
+  };
+
+  /**
+   * Six colour samples along +X, -X, +Y, -Y, +Z and -Z.
+   */
+  using CompressedLightCube = std::array<ColourRgbExp32, 6>;
+
+  /**
+   * Leaf for lump version 0, which stores a single ambient cube per leaf.
+   */
+  struct LeafV0 {
+    int32_t contents;
+    int16_t cluster;
+    int16_t area : 9;
+    int16_t flags : 7;
+    std::array<int16_t, 3> mins;
+    std::array<int16_t, 3> maxs;
+    uint16_t firstLeafFace;
+    uint16_t numLeafFaces;
+    uint16_t firstLeafBrush;
+    uint16_t numLeafBrushes;
+
+    /**
+     * Index into Bsp::leafWaterData, or -1 if the leaf isn't in water.
+     */
+    int16_t leafWaterDataId;
+    CompressedLightCube ambientLighting;
+    int16_t padding;
+  };
+
+  /**
+   * Leaf for lump version 1, with ambient lighting moved to the LeafAmbientLighting lumps.
+   */
+  struct LeafV1 {
+    int32_t contents;
+    int16_t cluster;
+    int16_t area : 9;
+    int16_t flags : 7;
+    std::array<int16_t, 3> mins;
+    std::array<int16_t, 3> maxs;
+    uint16_t firstLeafFace;
+    uint16_t numLeafFaces;
+    uint16_t firstLeafBrush;
+    uint16_t numLeafBrushes;
+
+    /**
+     * Index into Bsp::leafWaterData, or -1 if the leaf isn't in water.
+     */
+    int16_t leafWaterDataId;
+    int16_t padding;
+  };
+
+  struct LeafWaterData {
+    float surfaceZ;
+    float minZ;
+    int16_t surfaceTexInfo;
+    int16_t padding;
+  };
+}
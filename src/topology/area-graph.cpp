@@ -0,0 +1,140 @@
+#include "area-graph.hpp"
+#include "../helpers/parallel-for.hpp"
+#include <array>
+#include <stdexcept>
+
+namespace BspParser {
+  using namespace Internal;
+
+  AreaGraph::AreaGraph(const Bsp& bsp) {
+    offsets.reserve(bsp.areas.size() + 1);
+    offsets.push_back(0);
+    neighbours.reserve(bsp.areaPortals.size());
+    portalKeys.reserve(bsp.areaPortals.size());
+
+    for (const auto& area : bsp.areas) {
+      if (area.firstAreaPortal < 0 || area.numAreaPortals < 0 ||
+          area.firstAreaPortal + area.numAreaPortals > bsp.areaPortals.size()) {
+        throw Errors::OutOfBoundsAccess(
+          Enums::Lump::Areas,
+          std::format(
+            "Area's firstAreaPortal + numAreaPortals ({} + {}) is greater than the size of the area portals lump",
+            area.firstAreaPortal,
+            area.numAreaPortals
+          )
+        );
+      }
+
+      for (const auto& portal : bsp.areaPortals.subspan(area.firstAreaPortal, area.numAreaPortals)) {
+        if (portal.otherArea >= bsp.areas.size()) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::AreaPortals,
+            std::format("Area portal's other area '{}' is out of bounds of the areas lump", portal.otherArea)
+          );
+        }
+
+        if (portal.firstClipPortalVertex + portal.numClipPortalVertices > bsp.clipPortalVertices.size()) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::AreaPortals,
+            std::format(
+              "Area portal's firstClipPortalVertex + numClipPortalVertices ({} + {}) is greater than the size of the "
+              "clip portal vertices lump",
+              portal.firstClipPortalVertex,
+              portal.numClipPortalVertices
+            )
+          );
+        }
+
+        if (portal.portalKey >= Limits::MAX_MAP_AREAPORTALS) {
+          throw Errors::InvalidBody(
+            Enums::Lump::AreaPortals,
+            std::format(
+              "Area portal key ({}) exceeds source engine maximum ({})", portal.portalKey, Limits::MAX_MAP_AREAPORTALS
+            )
+          );
+        }
+
+        neighbours.push_back(portal.otherArea);
+        portalKeys.push_back(portal.portalKey);
+        allPortalKeys.set(portal.portalKey);
+      }
+
+      offsets.push_back(static_cast<uint32_t>(neighbours.size()));
+    }
+  }
+
+  size_t AreaGraph::getAreaCount() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+
+  std::span<const uint16_t> AreaGraph::getNeighbours(const uint16_t area) const {
+    assertAreaValid(area);
+
+    return std::span(neighbours).subspan(offsets[area], offsets[area + 1] - offsets[area]);
+  }
+
+  std::span<const uint16_t> AreaGraph::getPortalKeys(const uint16_t area) const {
+    assertAreaValid(area);
+
+    return std::span(portalKeys).subspan(offsets[area], offsets[area + 1] - offsets[area]);
+  }
+
+  AreaSet AreaGraph::getReachableAreas(const uint16_t area, const PortalKeySet& openPortals) const {
+    assertAreaValid(area);
+
+    AreaSet reached;
+    reached.set(area);
+
+    // Every area is pushed at most once, so the stack never outgrows the area limit
+    std::array<uint16_t, Limits::MAX_MAP_AREAS> stack;
+    size_t stackSize = 0;
+    stack[stackSize++] = area;
+
+    while (stackSize > 0) {
+      const auto current = stack[--stackSize];
+
+      for (auto portal = offsets[current]; portal < offsets[current + 1]; portal++) {
+        const auto neighbour = neighbours[portal];
+
+        if (!reached.test(neighbour) && openPortals.test(portalKeys[portal])) {
+          reached.set(neighbour);
+          stack[stackSize++] = neighbour;
+        }
+      }
+    }
+
+    return reached;
+  }
+
+  void AreaGraph::getReachableAreas(
+    const uint16_t area, const std::span<const PortalKeySet> portalStates, const std::span<AreaSet> reachableAreas
+  ) const {
+    assertAreaValid(area);
+
+    if (reachableAreas.size() < portalStates.size()) {
+      throw std::invalid_argument("Reachable areas must have an entry for every portal state");
+    }
+
+    parallelFor(
+      portalStates.size(),
+      [&](const size_t state) { reachableAreas[state] = getReachableAreas(area, portalStates[state]); },
+      256
+    );
+  }
+
+  bool AreaGraph::isReachable(const uint16_t fromArea, const uint16_t toArea, const PortalKeySet& openPortals) const {
+    assertAreaValid(toArea);
+
+    return getReachableAreas(fromArea, openPortals).test(toArea);
+  }
+
+  const PortalKeySet& AreaGraph::getAllPortalKeys() const {
+    return allPortalKeys;
+  }
+
+  void AreaGraph::assertAreaValid(const uint16_t area) const {
+    if (area >= getAreaCount()) {
+      throw std::out_of_range(std::format("Area '{}' is out of bounds of the area graph", area));
+    }
+  }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include "../limits.hpp"
+#include <bitset>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  using AreaSet = std::bitset<Limits::MAX_MAP_AREAS>;
+
+  /**
+   * Set of open area portals, indexed by portal key.
+   */
+  using PortalKeySet = std::bitset<Limits::MAX_MAP_AREAPORTALS>;
+
+  /**
+   * Areas connected by their area portals, stored as a compressed list for flood filling under different sets of
+   * open portals. Area 0 is the solid area and has no portals.
+   */
+  class AreaGraph {
+  public:
+    AreaGraph() = default;
+
+    /**
+     * @param bsp BSP instance.
+     * @throws Errors::OutOfBoundsAccess An area references out of bounds portals, or a portal an out of bounds area or
+     * clip portal vertices.
+     * @throws Errors::InvalidBody A portal key doesn't fit in a PortalKeySet.
+     */
+    explicit AreaGraph(const Bsp& bsp);
+
+    [[nodiscard]] size_t getAreaCount() const;
+
+    /**
+     * Areas the portals of an area look into, parallel to getPortalKeys.
+     */
+    [[nodiscard]] std::span<const uint16_t> getNeighbours(uint16_t area) const;
+
+    /**
+     * Keys of the portals of an area, parallel to getNeighbours.
+     */
+    [[nodiscard]] std::span<const uint16_t> getPortalKeys(uint16_t area) const;
+
+    /**
+     * Flood fills outward from an area through open portals.
+     * @param area Area to start from.
+     * @param openPortals Keys of the portals which are open.
+     * @return The areas reachable from area, including itself.
+     * @throws std::out_of_range The area doesn't exist.
+     */
+    [[nodiscard]] AreaSet getReachableAreas(uint16_t area, const PortalKeySet& openPortals) const;
+
+    /**
+     * Flood fills outward from an area once per set of open portals, in parallel.
+     * @param area Area to start from.
+     * @param portalStates Sets of open portals to evaluate, such as every combination of a group of doors.
+     * @param reachableAreas Receives the reachable areas for each portal state. Must be at least portalStates.size()
+     * long.
+     * @throws std::out_of_range The area doesn't exist.
+     * @throws std::invalid_argument reachableAreas is shorter than portalStates.
+     */
+    void getReachableAreas(
+      uint16_t area, std::span<const PortalKeySet> portalStates, std::span<AreaSet> reachableAreas
+    ) const;
+
+    [[nodiscard]] bool isReachable(uint16_t fromArea, uint16_t toArea, const PortalKeySet& openPortals) const;
+
+    /**
+     * Keys of every portal in the BSP, for building portal states where every portal is open.
+     */
+    [[nodiscard]] const PortalKeySet& getAllPortalKeys() const;
+
+  private:
+    /**
+     * Offsets into neighbours and portalKeys for each area, plus a final end offset.
+     */
+    std::vector<uint32_t> offsets;
+    std::vector<uint16_t> neighbours;
+    std::vector<uint16_t> portalKeys;
+
+    PortalKeySet allPortalKeys;
+
+    void assertAreaValid(uint16_t area) const;
+  };
+}
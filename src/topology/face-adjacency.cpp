@@ -0,0 +1,182 @@
+#include "face-adjacency.hpp"
+#include "../helpers/parallel-for.hpp"
+#include "../helpers/vector-maths.hpp"
+#include <cmath>
+
+namespace BspParser {
+  using namespace Internal;
+
+  namespace {
+    std::span<const int32_t> getFaceSurfaceEdges(const Bsp& bsp, const Structs::Face& face) {
+      if (face.firstEdge < 0 || face.numEdges < 0 || face.firstEdge + face.numEdges > bsp.surfaceEdges.size()) {
+        throw Errors::OutOfBoundsAccess(
+          Enums::Lump::Faces,
+          std::format(
+            "Face's firstEdge + numEdges ({} + {}) is out of bounds of the surf edges lump",
+            face.firstEdge,
+            face.numEdges
+          )
+        );
+      }
+
+      return bsp.surfaceEdges.subspan(face.firstEdge, face.numEdges);
+    }
+
+    uint32_t getFirstVertex(const Bsp& bsp, const int32_t surfaceEdge) {
+      const auto& edge = bsp.edges[std::abs(surfaceEdge)];
+      return surfaceEdge < 0 ? edge.vertices.back() : edge.vertices.front();
+    }
+
+    /**
+     * Counting sort of (key, face) pairs into a compressed list. Faces are visited in order so each list is ascending.
+     */
+    template <typename GetKeys>
+    void buildCompressedList(
+      const Bsp& bsp,
+      const size_t numKeys,
+      const GetKeys& getKeys,
+      std::vector<uint32_t>& offsets,
+      std::vector<uint32_t>& values
+    ) {
+      offsets.assign(numKeys + 1, 0);
+
+      for (const auto& face : bsp.faces) {
+        getKeys(face, [&offsets](const size_t key) { offsets[key + 1]++; });
+      }
+
+      for (size_t key = 0; key < numKeys; key++) {
+        offsets[key + 1] += offsets[key];
+      }
+
+      values.resize(offsets.back());
+      auto cursors = std::vector(offsets.begin(), offsets.end() - 1);
+
+      for (uint32_t faceIndex = 0; faceIndex < bsp.faces.size(); faceIndex++) {
+        getKeys(bsp.faces[faceIndex], [&](const size_t key) {
+          // A degenerate face can reference the same key twice, which would otherwise list it twice
+          const auto cursor = cursors[key];
+          if (cursor > offsets[key] && values[cursor - 1] == faceIndex) {
+            return;
+          }
+
+          values[cursors[key]++] = faceIndex;
+        });
+      }
+
+      // Compact out the slots left by skipped duplicates
+      size_t write = 0;
+      for (size_t key = 0; key < numKeys; key++) {
+        const auto start = offsets[key];
+        offsets[key] = static_cast<uint32_t>(write);
+
+        for (auto read = start; read < cursors[key]; read++) {
+          values[write++] = values[read];
+        }
+      }
+      offsets[numKeys] = static_cast<uint32_t>(write);
+      values.resize(write);
+    }
+  }
+
+  FaceAdjacency::FaceAdjacency(const Bsp& bsp) {
+    for (const auto& face : bsp.faces) {
+      for (const auto surfaceEdge : getFaceSurfaceEdges(bsp, face)) {
+        const auto edgeIndex = static_cast<size_t>(std::abs(surfaceEdge));
+        if (edgeIndex >= bsp.edges.size()) {
+          throw Errors::OutOfBoundsAccess(
+            Enums::Lump::SurfaceEdges,
+            std::format("Surface edge index '{}' is out of bounds of the edges lump", edgeIndex)
+          );
+        }
+
+        for (const auto vertex : bsp.edges[edgeIndex].vertices) {
+          if (vertex >= bsp.vertices.size()) {
+            throw Errors::OutOfBoundsAccess(
+              Enums::Lump::Edges, std::format("Edge vertex index '{}' is out of bounds of the vertices lump", vertex)
+            );
+          }
+        }
+      }
+    }
+
+    buildCompressedList(
+      bsp,
+      bsp.edges.size(),
+      [&bsp](const Structs::Face& face, const auto& emit) {
+        for (const auto surfaceEdge : getFaceSurfaceEdges(bsp, face)) {
+          emit(static_cast<size_t>(std::abs(surfaceEdge)));
+        }
+      },
+      edgeFaceOffsets,
+      edgeFaces
+    );
+
+    buildCompressedList(
+      bsp,
+      bsp.vertices.size(),
+      [&bsp](const Structs::Face& face, const auto& emit) {
+        for (const auto surfaceEdge : getFaceSurfaceEdges(bsp, face)) {
+          emit(getFirstVertex(bsp, surfaceEdge));
+        }
+      },
+      vertexFaceOffsets,
+      vertexFaces
+    );
+  }
+
+  std::span<const uint32_t> FaceAdjacency::getEdgeFaces(const size_t edgeIndex) const {
+    return std::span(edgeFaces)
+      .subspan(edgeFaceOffsets[edgeIndex], edgeFaceOffsets[edgeIndex + 1] - edgeFaceOffsets[edgeIndex]);
+  }
+
+  std::span<const uint32_t> FaceAdjacency::getVertexFaces(const size_t vertexIndex) const {
+    return std::span(vertexFaces)
+      .subspan(vertexFaceOffsets[vertexIndex], vertexFaceOffsets[vertexIndex + 1] - vertexFaceOffsets[vertexIndex]);
+  }
+
+  std::vector<Structs::Vector> generateSmoothNormals(const Bsp& bsp, const FaceAdjacency& adjacency) {
+    std::vector<Structs::Vector> normals(bsp.surfaceEdges.size());
+
+    const auto getPlaneNormal = [&bsp](const Structs::Face& face) {
+      return face.planeNum < bsp.planes.size() ? bsp.planes[face.planeNum].normal : Structs::Vector{};
+    };
+
+    // Faces write disjoint ranges of surface edges, so they can be smoothed independently
+    parallelFor(
+      bsp.faces.size(),
+      [&](const size_t faceIndex) {
+        const auto& face = bsp.faces[faceIndex];
+        if (face.numEdges <= 0) {
+          return;
+        }
+
+        const auto surfaceEdges = bsp.surfaceEdges.subspan(face.firstEdge, face.numEdges);
+        const auto flatNormal = getPlaneNormal(face);
+
+        for (size_t corner = 0; corner < surfaceEdges.size(); corner++) {
+          auto& normal = normals[face.firstEdge + corner];
+          if (face.smoothingGroups == 0 || face.dispInfo >= 0) {
+            normal = flatNormal;
+            continue;
+          }
+
+          auto sum = Structs::Vector{};
+          for (const auto otherIndex : adjacency.getVertexFaces(getFirstVertex(bsp, surfaceEdges[corner]))) {
+            const auto& other = bsp.faces[otherIndex];
+            if (other.dispInfo >= 0 || (other.smoothingGroups & face.smoothingGroups) == 0) {
+              continue;
+            }
+
+            sum = add(sum, mul(getPlaneNormal(other), other.area));
+          }
+
+          const auto sumLength = length(sum);
+          normal = sumLength > 0.f ? div(sum, sumLength) : flatNormal;
+        }
+      },
+      64
+    );
+
+    return normals;
+  }
+}
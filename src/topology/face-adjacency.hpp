@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../bsp.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BspParser {
+  /**
+   * Faces sharing each edge and each vertex, stored as compressed lists.
+   * Built in linear time with counting sorts over the surface edges, and reusable for smoothing, welding,
+   * outlines and face merging.
+   */
+  struct FaceAdjacency {
+    FaceAdjacency() = default;
+
+    /**
+     * @param bsp BSP instance.
+     * @throws Errors::OutOfBoundsAccess A face's surface edges or an edge's vertices are out of bounds.
+     */
+    explicit FaceAdjacency(const Bsp& bsp);
+
+    /**
+     * Offsets into edgeFaces for each edge in Bsp::edges, plus a final end offset.
+     */
+    std::vector<uint32_t> edgeFaceOffsets;
+    std::vector<uint32_t> edgeFaces;
+
+    /**
+     * Offsets into vertexFaces for each vertex in Bsp::vertices, plus a final end offset.
+     */
+    std::vector<uint32_t> vertexFaceOffsets;
+    std::vector<uint32_t> vertexFaces;
+
+    /**
+     * Indices of the faces using an edge, in ascending order. Boundary edges have one face and manifold edges two.
+     */
+    [[nodiscard]] std::span<const uint32_t> getEdgeFaces(size_t edgeIndex) const;
+
+    /**
+     * Indices of the faces touching a vertex, in ascending order.
+     */
+    [[nodiscard]] std::span<const uint32_t> getVertexFaces(size_t vertexIndex) const;
+  };
+
+  /**
+   * Generates smooth normals for brush faces from their smoothing groups, for BSPs without compiled vertex normals.
+   * Each corner takes the area-weighted average of the plane normals of every face touching its vertex
+   * which shares a smoothing group bit with the corner's face. Faces with no smoothing groups stay flat,
+   * and displacement faces are ignored.
+   * @param bsp BSP instance.
+   * @param adjacency Adjacency built from the same BSP.
+   * @return A normal per surface edge, indexed the same as Bsp::surfaceEdges.
+   */
+  std::vector<Structs::Vector> generateSmoothNormals(const Bsp& bsp, const FaceAdjacency& adjacency);
+}
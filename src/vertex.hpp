@@ -8,6 +8,12 @@ namespace BspParser {
     Structs::Vector normal;
     Structs::Vector4 tangent;
     Structs::Vector2 uv;
+
+    /**
+     * Normalised coordinates within the face's lightmap, pointing at luxel centres.
+     * Use LightmapAtlas to remap these into an atlas page.
+     */
+    Structs::Vector2 lightmapUv;
     float alpha = 0.f;
   };
 }